@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "cepton_ros/CompactPointCloud.h"
+#include "cepton_ros/point.hpp"
+
+namespace cepton_ros {
+
+/// Converts float to half precision float, rounding to nearest even.
+inline uint16_t float_to_half(float value) {
+  const uint32_t f32_infinity = 255u << 23;
+  const uint32_t f16_max = (127u + 16u) << 23;
+  const uint32_t denormal_magic_bits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+  float denormal_magic;
+  std::memcpy(&denormal_magic, &denormal_magic_bits, sizeof(float));
+
+  uint32_t f;
+  std::memcpy(&f, &value, sizeof(float));
+  const uint32_t sign = f & 0x80000000u;
+  f ^= sign;
+
+  uint16_t h;
+  if (f >= f16_max) {
+    // Inf or NaN
+    h = (f > f32_infinity) ? 0x7e00 : 0x7c00;
+  } else if (f < (113u << 23)) {
+    // Denormal
+    float tmp;
+    std::memcpy(&tmp, &f, sizeof(float));
+    tmp += denormal_magic;
+    std::memcpy(&f, &tmp, sizeof(float));
+    h = uint16_t(f - denormal_magic_bits);
+  } else {
+    const uint32_t mantissa_odd = (f >> 13) & 1;
+    f += (uint32_t(15 - 127) << 23) + 0xfff;
+    f += mantissa_odd;
+    h = uint16_t(f >> 13);
+  }
+  return h | uint16_t(sign >> 16);
+}
+
+/// Converts half precision float to float.
+inline float half_to_float(uint16_t h) {
+  const uint32_t shifted_exponent = 0x7c00u << 13;
+  uint32_t f = uint32_t(h & 0x7fff) << 13;
+  const uint32_t exponent = shifted_exponent & f;
+  f += (127u - 15u) << 23;
+  if (exponent == shifted_exponent) {
+    // Inf or NaN
+    f += (128u - 16u) << 23;
+  } else if (exponent == 0) {
+    // Denormal
+    const uint32_t magic_bits = 113u << 23;
+    float magic, tmp;
+    std::memcpy(&magic, &magic_bits, sizeof(float));
+    f += 1u << 23;
+    std::memcpy(&tmp, &f, sizeof(float));
+    tmp -= magic;
+    std::memcpy(&f, &tmp, sizeof(float));
+  }
+  f |= uint32_t(h & 0x8000) << 16;
+  float value;
+  std::memcpy(&value, &f, sizeof(float));
+  return value;
+}
+
+/// Decodes points. Only position and intensity are set.
+inline void decode_compact_point_cloud(const CompactPointCloud &msg,
+                                       CeptonPointCloud &point_cloud) {
+  point_cloud.clear();
+  if (msg.data.size() < std::size_t(msg.n_points) * msg.point_size) return;
+  point_cloud.height = 1;
+  point_cloud.width = msg.n_points;
+  point_cloud.resize(msg.n_points);
+  const uint8_t *data = msg.data.data();
+  for (auto &point : point_cloud.points) {
+    point = cepton_sdk::util::SensorPoint();
+    point.valid = 1;
+    if (msg.encoding == CompactPointCloud::ENCODING_FLOAT16) {
+      uint16_t values[4];
+      std::memcpy(values, data, sizeof(values));
+      point.x = half_to_float(values[0]);
+      point.y = half_to_float(values[1]);
+      point.z = half_to_float(values[2]);
+      point.intensity = half_to_float(values[3]);
+    } else {
+      int16_t values[3];
+      std::memcpy(values, data, sizeof(values));
+      point.x = values[0] * msg.scale;
+      point.y = values[1] * msg.scale;
+      point.z = values[2] * msg.scale;
+      point.intensity = data[sizeof(values)] * msg.intensity_scale;
+    }
+    data += msg.point_size;
+  }
+}
+
+}  // namespace cepton_ros
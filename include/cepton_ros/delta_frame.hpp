@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <pcl_conversions/pcl_conversions.h>
+
+#include "cepton_ros/DeltaFrame.h"
+#include "cepton_ros/image_grid.hpp"
+#include "cepton_ros/point.hpp"
+
+namespace cepton_ros {
+
+/// Sparse image grid of points, at most one per cell.
+/**
+ * Points are stored densely, so clearing and iterating is proportional to
+ * the number of points, not cells.
+ */
+class CellPoints {
+ public:
+  void resize(int n_cells) {
+    m_indices.assign(n_cells, -1);
+    m_cells.clear();
+    m_points.clear();
+  }
+
+  int n_cells() const { return int(m_indices.size()); }
+
+  /// Returns nullptr if cell is empty.
+  const cepton_sdk::util::SensorPoint *find(int cell) const {
+    const int i = m_indices[cell];
+    return (i < 0) ? nullptr : &m_points[i];
+  }
+
+  void set(int cell, const cepton_sdk::util::SensorPoint &point) {
+    int &i = m_indices[cell];
+    if (i < 0) {
+      i = int(m_points.size());
+      m_cells.push_back(cell);
+      m_points.push_back(point);
+    } else {
+      m_points[i] = point;
+    }
+  }
+
+  void erase(int cell) {
+    const int i = m_indices[cell];
+    if (i < 0) return;
+    // Move last point into hole
+    m_indices[m_cells.back()] = i;
+    m_cells[i] = m_cells.back();
+    m_points[i] = m_points.back();
+    m_cells.pop_back();
+    m_points.pop_back();
+    m_indices[cell] = -1;
+  }
+
+  void clear() {
+    for (const int cell : m_cells) m_indices[cell] = -1;
+    m_cells.clear();
+    m_points.clear();
+  }
+
+  /// Releases storage. Call `resize` before reuse.
+  void release() {
+    std::vector<int32_t>().swap(m_indices);
+    std::vector<int32_t>().swap(m_cells);
+    std::vector<cepton_sdk::util::SensorPoint>().swap(m_points);
+  }
+
+  const std::vector<int32_t> &cells() const { return m_cells; }
+  const std::vector<cepton_sdk::util::SensorPoint> &points() const {
+    return m_points;
+  }
+
+ private:
+  std::vector<int32_t> m_indices;
+  std::vector<int32_t> m_cells;
+  std::vector<cepton_sdk::util::SensorPoint> m_points;
+};
+
+/// Encodes frames as changes relative to the receiver state.
+/**
+ * Valid points are binned into image grid cells (nearest point per cell).
+ * Cells are compared against the last values sent, not the previous frame,
+ * so slow drift is eventually sent. Every `keyframe_interval` frames, all
+ * points are sent, so that receivers can join or recover from drops.
+ *
+ * The encoding is lossy: only the nearest point per cell is kept, so second
+ * returns, and points that share a cell with a nearer point (more likely at
+ * the image edges, where scan lines converge), are dropped. They are counted
+ * in `n_dropped`.
+ */
+class DeltaEncoder {
+ public:
+  /// Releases state. Next frame is a keyframe.
+  void reset() {
+    m_current.release();
+    m_reference.release();
+    m_n_frames = 0;
+  }
+
+  void encode(const CeptonPointCloud &point_cloud, DeltaFrame &msg) {
+    if (m_current.n_cells() != grid.size()) {
+      m_current.resize(grid.size());
+      m_reference.resize(grid.size());
+      m_n_frames = 0;
+    }
+
+    // Bin points
+    m_current.clear();
+    n_dropped = 0;
+    for (const auto &point : point_cloud.points) {
+      if (!point.valid) continue;
+      const int cell = grid.get_index(point.image_x, point.image_z);
+      if (cell < 0) {
+        ++n_dropped;
+        continue;
+      }
+      const auto *const other = m_current.find(cell);
+      if (other) ++n_dropped;
+      if (!other || (point.distance < other->distance))
+        m_current.set(cell, point);
+    }
+
+    msg.header = pcl_conversions::fromPCL(point_cloud.header);
+    msg.sequence = uint32_t(m_n_frames);
+    msg.is_keyframe = (m_n_frames % std::max(keyframe_interval, 1)) == 0;
+    msg.grid_resolution = grid.resolution;
+    msg.grid_extent = grid.extent;
+    msg.removed_cells.clear();
+    msg.cells.clear();
+    m_changed.clear();
+    m_changed.header = point_cloud.header;
+
+    if (msg.is_keyframe) m_reference.clear();
+    for (std::size_t i = 0; i < m_current.cells().size(); ++i) {
+      const int cell = m_current.cells()[i];
+      const auto &point = m_current.points()[i];
+      const auto *const reference = m_reference.find(cell);
+      if (reference &&
+          (std::abs(point.distance - reference->distance) <= max_distance) &&
+          (std::abs(point.intensity - reference->intensity) <= max_intensity))
+        continue;
+      m_reference.set(cell, point);
+      msg.cells.push_back(cell);
+      m_changed.points.push_back(point);
+    }
+    for (const int cell : m_reference.cells()) {
+      if (!m_current.find(cell)) msg.removed_cells.push_back(cell);
+    }
+    for (const int cell : msg.removed_cells) m_reference.erase(cell);
+
+    m_changed.height = 1;
+    m_changed.width = m_changed.points.size();
+    pcl::toROSMsg(m_changed, msg.points);
+    ++m_n_frames;
+  }
+
+ public:
+  // Options
+  ImageGrid grid{0.002f};
+  int keyframe_interval = 10;
+  float max_distance = 0.05f;  ///< Distance change threshold [meters].
+  float max_intensity = 0.1f;  ///< Intensity change threshold.
+
+  // Outputs
+  /// Valid points of last frame that were not encoded (outside of grid, or
+  /// not nearest in cell).
+  std::size_t n_dropped = 0;
+
+ private:
+  int64_t m_n_frames = 0;
+  CellPoints m_current;
+  CellPoints m_reference;
+  CeptonPointCloud m_changed;
+};
+
+/// Reconstructs frames from `cepton/points_delta` delta frames.
+/**
+ * Use one decoder per sensor serial number. Frames can only be reconstructed
+ * after the first keyframe. If a delta frame is missing (sequence gap), later
+ * deltas are dropped until the next keyframe. Reconstructed frames have at
+ * most one point per grid cell, and are not in scan order.
+ */
+class DeltaDecoder {
+ public:
+  /// Applies delta. Returns true if frame is valid.
+  bool add_delta(const DeltaFrame &msg) {
+    const ImageGrid grid(msg.grid_resolution, msg.grid_extent);
+    if (msg.is_keyframe) {
+      if (m_cells.n_cells() != grid.size())
+        m_cells.resize(grid.size());
+      else
+        m_cells.clear();
+      m_is_valid = true;
+    } else if (msg.sequence != m_sequence + 1) {
+      m_is_valid = false;
+    }
+    m_sequence = msg.sequence;
+    if (!m_is_valid) return false;
+
+    pcl::fromROSMsg(msg.points, m_changed);
+    if ((m_cells.n_cells() != grid.size()) ||
+        (m_changed.size() != msg.cells.size())) {
+      m_is_valid = false;
+      return false;
+    }
+    for (const int cell : msg.removed_cells) {
+      if ((cell >= 0) && (cell < m_cells.n_cells())) m_cells.erase(cell);
+    }
+    for (std::size_t i = 0; i < msg.cells.size(); ++i) {
+      const int cell = msg.cells[i];
+      if ((cell >= 0) && (cell < m_cells.n_cells()))
+        m_cells.set(cell, m_changed.points[i]);
+    }
+
+    m_frame.header = m_changed.header;
+    m_frame.points.assign(m_cells.points().begin(), m_cells.points().end());
+    m_frame.height = 1;
+    m_frame.width = m_frame.points.size();
+    return true;
+  }
+
+  /// Returns frame. Only valid after `add_delta` returns true.
+  const CeptonPointCloud &get_frame() const { return m_frame; }
+
+ private:
+  bool m_is_valid = false;
+  uint32_t m_sequence = 0;
+  CellPoints m_cells;
+  CeptonPointCloud m_changed;
+  CeptonPointCloud m_frame;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+
+#include <pcl_conversions/pcl_conversions.h>
+#include <cepton_sdk.hpp>
+
+#include "cepton_ros/PointCloudChunk.h"
+#include "cepton_ros/point.hpp"
+
+namespace cepton_ros {
+
+/// Assembles `cepton/points_chunks` chunks into frames.
+/**
+ * Use one assembler per sensor serial number. The frame buffer is
+ * preallocated, so appending chunks does not allocate. Frames with missing
+ * chunks are dropped.
+ *
+ * Per chunk work can be pipelined with acquisition, by processing
+ * `get_chunk()` after each call to `add_chunk`.
+ */
+class FrameAssembler {
+ public:
+  FrameAssembler() { m_frame.reserve(CEPTON_SDK_MAX_POINTS_PER_FRAME); }
+
+  /// Adds chunk. Returns true if frame is complete.
+  bool add_chunk(const PointCloudChunk &chunk) {
+    pcl::fromROSMsg(chunk.points, m_chunk);
+
+    if (chunk.chunk_index == 0) {
+      m_frame.clear();
+      m_frame_index = chunk.frame_index;
+      m_i_chunk = 0;
+      m_is_valid = true;
+    } else if ((chunk.frame_index != m_frame_index) ||
+               (chunk.chunk_index != m_i_chunk)) {
+      m_is_valid = false;
+    }
+    if (!m_is_valid) return false;
+    ++m_i_chunk;
+
+    m_frame.points.insert(m_frame.points.end(), m_chunk.points.begin(),
+                          m_chunk.points.end());
+    m_frame.height = 1;
+    m_frame.width = m_frame.points.size();
+    if (!m_chunk.empty() || (chunk.chunk_index == 0))
+      m_frame.header = m_chunk.header;
+
+    if (!chunk.is_last) return false;
+    m_is_valid = false;
+    return true;
+  }
+
+  /// Returns last chunk.
+  const CeptonPointCloud &get_chunk() const { return m_chunk; }
+  /// Returns frame. Only complete after `add_chunk` returns true.
+  const CeptonPointCloud &get_frame() const { return m_frame; }
+
+ private:
+  CeptonPointCloud m_chunk;
+  CeptonPointCloud m_frame;
+  uint32_t m_frame_index = 0;
+  uint32_t m_i_chunk = 0;
+  bool m_is_valid = false;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace cepton_ros {
+
+/// Fixed bin histogram for latency and timing measurements.
+/**
+ * Values outside of range are clamped to the first/last bin.
+ */
+class Histogram {
+ public:
+  Histogram(double min_value = 0.0, double max_value = 1.0, int n_bins = 1000)
+      : m_min(min_value),
+        m_bin_width((max_value - min_value) / n_bins),
+        m_counts(n_bins, 0) {}
+
+  void clear() {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    n = 0;
+    sum = 0.0;
+    sum_squares = 0.0;
+    max = -INFINITY;
+  }
+
+  void add(double value) {
+    const int i = std::min<int>(
+        std::max<int>(std::floor((value - m_min) / m_bin_width), 0),
+        m_counts.size() - 1);
+    ++m_counts[i];
+    ++n;
+    sum += value;
+    sum_squares += value * value;
+    max = std::max(max, value);
+  }
+
+  double mean() const { return (n) ? sum / n : 0.0; }
+
+  double stddev() const {
+    if (n < 2) return 0.0;
+    return std::sqrt(std::max(sum_squares / n - mean() * mean(), 0.0));
+  }
+
+  /// Returns upper edge of bin containing percentile `p` (0-1).
+  double percentile(double p) const {
+    if (!n) return 0.0;
+    const uint64_t n_target = std::ceil(p * n);
+    uint64_t n_total = 0;
+    for (std::size_t i = 0; i < m_counts.size(); ++i) {
+      n_total += m_counts[i];
+      if (n_total >= n_target) return m_min + (i + 1) * m_bin_width;
+    }
+    return m_min + m_counts.size() * m_bin_width;
+  }
+
+ public:
+  // Outputs
+  uint64_t n = 0;
+  double sum = 0.0;
+  double sum_squares = 0.0;
+  double max = -INFINITY;
+
+ private:
+  double m_min;
+  double m_bin_width;
+  std::vector<uint64_t> m_counts;
+};
+
+}  // namespace cepton_ros
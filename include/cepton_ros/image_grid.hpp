@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cmath>
+
+namespace cepton_ros {
+
+/// Regular grid over image coordinates.
+/**
+ * Image coordinates are tangents of the point angles, so a cell covers a
+ * roughly constant solid angle near the image center. Points outside of the
+ * grid extent are ignored.
+ */
+class ImageGrid {
+ public:
+  ImageGrid(float resolution_ = 0.01f, float extent_ = 1.0f)
+      : resolution(resolution_),
+        extent(extent_),
+        width(int(std::ceil(2.0f * extent_ / resolution_))),
+        height(width) {}
+
+  int size() const { return width * height; }
+
+  /// Returns false if outside of grid.
+  bool get_cell(float image_x, float image_z, int &i_x, int &i_z) const {
+    i_x = int(std::floor((image_x + extent) / resolution));
+    i_z = int(std::floor((image_z + extent) / resolution));
+    return is_valid(i_x, i_z);
+  }
+
+  bool is_valid(int i_x, int i_z) const {
+    return (i_x >= 0) && (i_x < width) && (i_z >= 0) && (i_z < height);
+  }
+
+  int get_index(int i_x, int i_z) const { return i_z * width + i_x; }
+
+  /// Returns -1 if outside of grid.
+  int get_index(float image_x, float image_z) const {
+    int i_x, i_z;
+    if (!get_cell(image_x, image_z, i_x, i_z)) return -1;
+    return get_index(i_x, i_z);
+  }
+
+ public:
+  float resolution;  ///< Cell size.
+  float extent;      ///< Grid covers [-extent, extent] on both axes.
+  int width;
+  int height;
+};
+
+}  // namespace cepton_ros
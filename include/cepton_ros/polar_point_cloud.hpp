@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "cepton_ros/PolarPointCloud.h"
+#include "cepton_ros/point.hpp"
+
+namespace cepton_ros {
+
+const int polar_point_size = 3 * sizeof(uint16_t) + sizeof(uint8_t);
+const int polar_n_indices = 1 << 16;
+/// Image coordinates range is [-polar_image_extent, polar_image_extent].
+const float polar_image_extent = 2.0f;
+
+/// Encodes valid points.
+/**
+ * The range field is the forward range (sensor y), instead of the distance,
+ * so that decoding positions is a multiply per coordinate.
+ */
+inline void encode_polar_point_cloud(const CeptonPointCloud &point_cloud,
+                                     float range_resolution,
+                                     PolarPointCloud &msg) {
+  msg.image_extent = polar_image_extent;
+  msg.image_scale = 2.0f * polar_image_extent / (polar_n_indices - 1);
+  msg.range_scale = range_resolution;
+  msg.data.resize(point_cloud.points.size() * polar_point_size);
+  msg.n_points = 0;
+
+  const float index_scale = 1.0f / msg.image_scale;
+  const float range_scale_inv = 1.0f / range_resolution;
+  const auto to_index = [index_scale](float value) {
+    return uint16_t(std::lround(
+        std::min(std::max((value + polar_image_extent) * index_scale, 0.0f),
+                 float(polar_n_indices - 1))));
+  };
+  uint8_t *data = msg.data.data();
+  for (const auto &point : point_cloud.points) {
+    if (!point.valid) continue;
+    const float range =
+        point.distance / std::sqrt(point.image_x * point.image_x +
+                                   point.image_z * point.image_z + 1.0f);
+    const uint16_t values[3] = {
+        to_index(point.image_x), to_index(point.image_z),
+        uint16_t(std::lround(std::min(range * range_scale_inv, 65535.0f)))};
+    std::memcpy(data, values, sizeof(values));
+    data[sizeof(values)] = uint8_t(
+        std::lround(std::min(std::max(point.intensity, 0.0f), 1.0f) * 255));
+    data += polar_point_size;
+    ++msg.n_points;
+  }
+  msg.data.resize(msg.n_points * polar_point_size);
+}
+
+/// Decodes polar points. Returns false if message is invalid.
+/**
+ * Image coordinates, position, and intensity are set. Distance needs a square
+ * root per point, so it is only set if `with_distance` is true.
+ */
+inline bool decode_polar_point_cloud(const PolarPointCloud &msg,
+                                     CeptonPointCloud &point_cloud,
+                                     bool with_distance = false) {
+  point_cloud.clear();
+  if (msg.data.size() < std::size_t(msg.n_points) * polar_point_size)
+    return false;
+  point_cloud.height = 1;
+  point_cloud.width = msg.n_points;
+  point_cloud.resize(msg.n_points);
+
+  const uint8_t *data = msg.data.data();
+  for (auto &point : point_cloud.points) {
+    uint16_t values[3];
+    std::memcpy(values, data, sizeof(values));
+    const float image_x = values[0] * msg.image_scale - msg.image_extent;
+    const float image_z = values[1] * msg.image_scale - msg.image_extent;
+    const float range = values[2] * msg.range_scale;
+
+    point = cepton_sdk::util::SensorPoint();
+    point.valid = 1;
+    point.image_x = image_x;
+    point.image_z = image_z;
+    point.intensity = data[sizeof(values)] * (1.0f / 255.0f);
+    point.x = -image_x * range;
+    point.y = range;
+    point.z = -image_z * range;
+    if (with_distance)
+      point.distance = std::sqrt(point.x * point.x + point.y * point.y +
+                                 point.z * point.z);
+    data += polar_point_size;
+  }
+  return true;
+}
+
+}  // namespace cepton_ros
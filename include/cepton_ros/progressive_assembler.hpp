@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#include <pcl_conversions/pcl_conversions.h>
+#include <cepton_sdk.hpp>
+
+#include "cepton_ros/ProgressiveLayer.h"
+#include "cepton_ros/compact_point_cloud.hpp"
+#include "cepton_ros/point.hpp"
+
+namespace cepton_ros {
+
+/// Assembles `cepton/points_progressive` layers into frames.
+/**
+ * Use one assembler per sensor serial number. The frame is usable (e.g. for
+ * rendering) after each layer; it is refined as later layers arrive. Layers
+ * are appended in arrival order, so points are not in scan order. Layers are
+ * compact encoded, so only position and intensity are set.
+ */
+class ProgressiveAssembler {
+ public:
+  ProgressiveAssembler() { m_frame.reserve(CEPTON_SDK_MAX_POINTS_PER_FRAME); }
+
+  /// Adds layer. Returns true if layer starts new frame.
+  bool add_layer(const ProgressiveLayer &layer) {
+    decode_compact_point_cloud(layer.points, m_layer);
+
+    const bool is_new = !m_has_frame || (layer.frame_index != m_frame_index);
+    if (is_new) {
+      m_frame.clear();
+      m_frame_index = layer.frame_index;
+      m_has_frame = true;
+      m_n_layers = 0;
+    }
+    m_is_complete = layer.is_last;
+    ++m_n_layers;
+
+    m_frame.points.insert(m_frame.points.end(), m_layer.points.begin(),
+                          m_layer.points.end());
+    m_frame.height = 1;
+    m_frame.width = m_frame.points.size();
+    m_frame.header = pcl_conversions::toPCL(layer.header);
+    return is_new;
+  }
+
+  /// Returns true if no more layers are expected for current frame.
+  bool is_complete() const { return m_is_complete; }
+  /// Returns number of layers received for current frame.
+  int get_n_layers() const { return m_n_layers; }
+  /// Returns current frame, refined up to last layer.
+  const CeptonPointCloud &get_frame() const { return m_frame; }
+
+ private:
+  CeptonPointCloud m_layer;
+  CeptonPointCloud m_frame;
+  uint32_t m_frame_index = 0;
+  int m_n_layers = 0;
+  bool m_has_frame = false;
+  bool m_is_complete = false;
+};
+
+}  // namespace cepton_ros
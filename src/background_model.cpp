@@ -0,0 +1,67 @@
+#include "background_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "grid_file.hpp"
+
+namespace cepton_ros {
+
+namespace {
+/// Value is number of frames.
+const GridFile grid_file = {{{'C', 'B', 'G', '1'}}, "background model"};
+}  // namespace
+
+bool BackgroundModel::add_point(const cepton_sdk::util::SensorPoint &point) {
+  if (m_distances.empty())
+    m_distances.assign(grid.size(), std::numeric_limits<float>::quiet_NaN());
+
+  const int i = grid.get_index(point.image_x, point.image_z);
+  if (i < 0) return !is_learning() && point.valid;
+  const float distance =
+      (point.valid) ? std::min(point.distance, max_distance) : max_distance;
+
+  float &background = m_distances[i];
+  if (std::isnan(background)) {
+    background = distance;
+    return !is_learning() && point.valid;
+  }
+  const bool is_foreground =
+      !is_learning() && point.valid &&
+      (background - distance >
+       std::max(min_difference, difference_ratio * background));
+
+  // Track median
+  const float rate = (is_learning()) ? learning_rate : adaptation_rate;
+  const float step = rate * std::max(background, 1.0f);
+  if (distance > background)
+    background = std::min(background + step, distance);
+  else if (distance < background)
+    background = std::max(background - step, distance);
+  return is_foreground;
+}
+
+void BackgroundModel::reset() {
+  std::vector<float>().swap(m_distances);
+  m_n_frames = 0;
+}
+
+bool BackgroundModel::load(const std::string &path) {
+  std::vector<float> distances(grid.size());
+  int64_t n_frames;
+  if (!grid_file.load(path, grid, distances.data(),
+                      distances.size() * sizeof(float), n_frames))
+    return false;
+  m_distances.swap(distances);
+  m_n_frames = n_frames;
+  return true;
+}
+
+bool BackgroundModel::save(const std::string &path) const {
+  if (m_distances.empty()) return false;
+  return grid_file.save(path, grid, m_distances.data(),
+                        m_distances.size() * sizeof(float), m_n_frames);
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <cepton_sdk_util.hpp>
+
+#include "cepton_ros/image_grid.hpp"
+
+namespace cepton_ros {
+
+/// Per cell background range model, for static sensors.
+/**
+ * Tracks the running median distance of each image grid cell, with a step
+ * proportional to the distance (frugal median). Points with no return are
+ * treated as `max_distance`. Points that are significantly closer than the
+ * background are foreground. Objects that stop moving are slowly absorbed
+ * into the background.
+ *
+ * During the first `learning_frames` frames, the model adapts faster, and no
+ * points are foreground.
+ */
+class BackgroundModel {
+ public:
+  /// Updates model with point. Returns true if point is foreground.
+  bool add_point(const cepton_sdk::util::SensorPoint &point);
+  /// Finishes current frame.
+  void next_frame() { ++m_n_frames; }
+  bool is_learning() const { return m_n_frames < learning_frames; }
+  /// Releases model. Next frames are learned from scratch.
+  void reset();
+
+  /// Loads model. Fails if grid does not match.
+  bool load(const std::string &path);
+  bool save(const std::string &path) const;
+
+ public:
+  // Options
+  ImageGrid grid{0.004f};
+  int learning_frames = 100;
+  float learning_rate = 0.1f;     ///< Step, relative to distance.
+  float adaptation_rate = 0.001f;  ///< Step, relative to distance.
+  float min_difference = 0.5f;    ///< [meters]
+  float difference_ratio = 0.05f;
+  float max_distance = 200.0f;  ///< [meters]
+
+ private:
+  std::vector<float> m_distances;  ///< NaN if not observed.
+  int64_t m_n_frames = 0;
+};
+
+}  // namespace cepton_ros
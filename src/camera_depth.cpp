@@ -0,0 +1,76 @@
+#include "camera_depth.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/make_shared.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <ros/ros.h>
+
+#include "transforms_watcher.hpp"
+
+namespace cepton_ros {
+
+bool load_cameras(const std::string &path, std::vector<CameraConfig> &cameras) {
+  cameras.clear();
+  try {
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_json(path, tree);
+    for (const auto &iter : tree) {
+      CameraConfig camera;
+      camera.name = iter.first;
+      camera.camera_info_topic = iter.second.get<std::string>("camera_info");
+      camera.frame_id = iter.second.get<std::string>("frame", "");
+      camera.transform = TransformsWatcher::parse_transform(iter.second);
+      cameras.push_back(camera);
+    }
+  } catch (const std::exception &e) {
+    ROS_WARN("Failed to load cameras %s: %s", path.c_str(), e.what());
+    return false;
+  }
+  return true;
+}
+
+void DepthImage::set_camera_info(const sensor_msgs::CameraInfo &camera_info) {
+  m_fx = camera_info.K[0];
+  m_fy = camera_info.K[4];
+  m_cx = camera_info.K[2];
+  m_cy = camera_info.K[5];
+  if (m_image && (int(camera_info.width) == m_width) &&
+      (int(camera_info.height) == m_height))
+    return;
+
+  m_width = camera_info.width;
+  m_height = camera_info.height;
+  m_image = boost::make_shared<sensor_msgs::Image>();
+  m_image->width = m_width;
+  m_image->height = m_height;
+  m_image->encoding = "32FC1";
+  m_image->is_bigendian = 0;
+  m_image->step = m_width * sizeof(float);
+  m_image->data.resize(m_image->step * m_height);
+  m_spare_image.reset();
+  clear();
+}
+
+sensor_msgs::ImageConstPtr DepthImage::finish(
+    const std_msgs::Header &header) {
+  const sensor_msgs::ImagePtr image = m_image;
+  image->header = header;
+
+  // Reuse previous image, unless subscribers still hold it
+  std::swap(m_image, m_spare_image);
+  if (!m_image || !m_image.unique())
+    m_image = boost::make_shared<sensor_msgs::Image>(*image);
+  clear();
+  return image;
+}
+
+void DepthImage::clear() {
+  m_depths = (float *)m_image->data.data();
+  std::fill(m_depths, m_depths + m_width * m_height,
+            std::numeric_limits<float>::quiet_NaN());
+}
+
+}  // namespace cepton_ros
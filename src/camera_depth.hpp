@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <sensor_msgs/CameraInfo.h>
+#include <sensor_msgs/Image.h>
+#include <cepton_sdk_util.hpp>
+
+namespace cepton_ros {
+
+/// Camera depth image settings.
+struct CameraConfig {
+  std::string name;
+  std::string camera_info_topic;
+  /// Points frame. If empty, the driver output frame.
+  std::string frame_id;
+  /// Transform from points frame to camera optical frame.
+  cepton_sdk::util::CompiledTransform transform;
+};
+
+/// Loads cameras file.
+/**
+ * Keys are camera names. Each camera has a "camera_info" topic, and optional
+ * "frame", "translation", and "rotation" (same format as
+ * `cepton_transforms.json`).
+ */
+bool load_cameras(const std::string &path, std::vector<CameraConfig> &cameras);
+
+/// Renders sparse depth image (32FC1, NaN if no return) for a camera.
+/**
+ * Points are projected with the camera intrinsics (distortion is ignored),
+ * and z-buffered. Image buffers are reused, unless a subscriber still holds
+ * the previous image.
+ */
+class DepthImage {
+ public:
+  bool empty() const { return !m_image; }
+
+  /// Sets intrinsics. Reallocates buffers if image size changed.
+  void set_camera_info(const sensor_msgs::CameraInfo &camera_info);
+
+  /// Adds point in points frame.
+  void add_point(float x, float y, float z) {
+    transform.apply(x, y, z);
+    if (z <= 0.0f) return;
+    const float z_inv = 1.0f / z;
+    const float u = m_fx * x * z_inv + m_cx;
+    const float v = m_fy * y * z_inv + m_cy;
+    if ((u < 0.0f) || (v < 0.0f) || (u >= m_width) || (v >= m_height)) return;
+    float &depth = m_depths[int(v) * m_width + int(u)];
+    if (!(depth <= z)) depth = z;
+  }
+
+  /// Returns rendered image, and starts next image.
+  sensor_msgs::ImageConstPtr finish(const std_msgs::Header &header);
+
+ public:
+  /// Transform from points frame to camera optical frame.
+  cepton_sdk::util::CompiledTransform transform;
+
+ private:
+  void clear();
+
+ private:
+  int m_width = 0;
+  int m_height = 0;
+  float m_fx = 0.0f;
+  float m_fy = 0.0f;
+  float m_cx = 0.0f;
+  float m_cy = 0.0f;
+
+  sensor_msgs::ImagePtr m_image;
+  sensor_msgs::ImagePtr m_spare_image;
+  float *m_depths = nullptr;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <cepton_sdk_api.hpp>
+
+#include "multi_capture_replay.hpp"
+
+namespace cepton_ros {
+
+/// Capture replay controls.
+/**
+ * Dispatches to the SDK capture replay for a single capture, or to
+ * `MultiCaptureReplay` for multiple captures.
+ */
+class CaptureReplay {
+ public:
+  bool is_open() const {
+    return m_multi.is_open() || cepton_sdk::capture_replay::is_open();
+  }
+
+  /// Opens captures.
+  /**
+   * `cepton_sdk::api::open_replay` replays the first 3 seconds to index the
+   * capture. If the capture has a prebuilt index (`<path>.cep0`), this is
+   * skipped.
+   */
+  cepton_sdk::SensorError open(const std::vector<std::string> &paths) {
+    if (paths.size() > 1) return m_multi.open(paths);
+    if (paths.empty()) return CEPTON_ERROR_INVALID_ARGUMENTS;
+    const std::string &path = paths[0];
+    if (!has_index(path)) return cepton_sdk::api::open_replay(path);
+    if (cepton_sdk::capture_replay::is_open()) {
+      const auto error = cepton_sdk::capture_replay::close();
+      if (error) return error;
+    }
+    return cepton_sdk::capture_replay::open(path);
+  }
+
+  cepton_sdk::SensorError close() {
+    if (m_multi.is_open()) return m_multi.close();
+    if (cepton_sdk::capture_replay::is_open())
+      return cepton_sdk::capture_replay::close();
+    return CEPTON_SUCCESS;
+  }
+
+  /// Capture position [seconds].
+  float get_position() const {
+    if (m_multi.is_open()) return m_multi.get_position();
+    return cepton_sdk::capture_replay::get_position();
+  }
+
+  /// Current capture timestamp [microseconds].
+  int64_t get_time() const {
+    if (m_multi.is_open()) return m_multi.get_time();
+    return int64_t(cepton_sdk::capture_replay::get_time());
+  }
+
+  /// Capture length [seconds].
+  float get_length() const {
+    if (m_multi.is_open()) return m_multi.get_length();
+    return cepton_sdk::capture_replay::get_length();
+  }
+
+  bool is_end() const {
+    if (m_multi.is_open()) return m_multi.is_end();
+    return cepton_sdk::capture_replay::is_end();
+  }
+
+  cepton_sdk::SensorError seek(float position) {
+    if (m_multi.is_open()) return m_multi.seek(position);
+    return cepton_sdk::capture_replay::seek(position);
+  }
+
+  cepton_sdk::SensorError set_enable_loop(bool value) {
+    if (m_multi.is_open()) return m_multi.set_enable_loop(value);
+    return cepton_sdk::capture_replay::set_enable_loop(value);
+  }
+
+  cepton_sdk::SensorError set_speed(float speed) {
+    if (m_multi.is_open()) return m_multi.set_speed(speed);
+    return cepton_sdk::capture_replay::set_speed(speed);
+  }
+
+  float get_speed() const {
+    if (m_multi.is_open()) return m_multi.get_speed();
+    return cepton_sdk::capture_replay::get_speed();
+  }
+
+  cepton_sdk::SensorError resume_blocking_once() {
+    if (m_multi.is_open()) return m_multi.resume_blocking_once();
+    return cepton_sdk::capture_replay::resume_blocking_once();
+  }
+
+  bool is_running() const {
+    if (m_multi.is_open()) return m_multi.is_running();
+    return cepton_sdk::capture_replay::is_running();
+  }
+
+  cepton_sdk::SensorError resume() {
+    if (m_multi.is_open()) return m_multi.resume();
+    return cepton_sdk::capture_replay::resume();
+  }
+
+  cepton_sdk::SensorError pause() {
+    if (m_multi.is_open()) return m_multi.pause();
+    return cepton_sdk::capture_replay::pause();
+  }
+
+ private:
+  static bool has_index(const std::string &path) {
+    return std::ifstream(path + ".cep0").good();
+  }
+
+ private:
+  MultiCaptureReplay m_multi;
+};
+
+}  // namespace cepton_ros
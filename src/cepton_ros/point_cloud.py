@@ -0,0 +1,153 @@
+"""NumPy views of `cepton/points` messages, and decoders for the reduced
+size encodings (`cepton/points_compact`, `cepton/points_polar`).
+
+Example:
+
+    import cepton_ros.point_cloud
+
+    def on_points(msg):
+        points = cepton_ros.point_cloud.to_numpy(msg)
+        xyz = points[["x", "y", "z"]]
+        valid = (points["flags"] & cepton_ros.point_cloud.FLAG_VALID) != 0
+
+    rospy.Subscriber("cepton/points", sensor_msgs.msg.PointCloud2, on_points)
+"""
+
+from __future__ import (absolute_import, division, generators, nested_scopes,
+                        print_function, with_statement)
+
+import numpy
+
+from sensor_msgs.msg import PointField
+
+# `CompactPointCloud` encodings
+ENCODING_FLOAT16 = 0
+ENCODING_INT16 = 1
+
+FLAG_VALID = 1 << 0
+FLAG_SATURATED = 1 << 1
+
+_POINT_FIELD_DTYPES = {
+    PointField.INT8: numpy.int8,
+    PointField.UINT8: numpy.uint8,
+    PointField.INT16: numpy.int16,
+    PointField.UINT16: numpy.uint16,
+    PointField.INT32: numpy.int32,
+    PointField.UINT32: numpy.uint32,
+    PointField.FLOAT32: numpy.float32,
+    PointField.FLOAT64: numpy.float64,
+}
+
+# `timestamp` is registered as FLOAT64 (PCL does not support int64), but the
+# bytes are `int64` unix time [microseconds].
+_FIELD_DTYPE_OVERRIDES = {
+    "timestamp": numpy.int64,
+}
+
+
+def get_dtype(msg):
+    """Returns structured dtype matching `msg.fields`, including padding."""
+    names = []
+    formats = []
+    offsets = []
+    for field in msg.fields:
+        dtype = _FIELD_DTYPE_OVERRIDES.get(
+            field.name, _POINT_FIELD_DTYPES[field.datatype])
+        dtype = numpy.dtype(dtype).newbyteorder(
+            ">" if msg.is_bigendian else "<")
+        names.append(str(field.name))
+        formats.append(dtype if field.count == 1 else (dtype, field.count))
+        offsets.append(field.offset)
+    return numpy.dtype({
+        "names": names,
+        "formats": formats,
+        "offsets": offsets,
+        "itemsize": msg.point_step,
+    })
+
+
+def to_numpy(msg):
+    """Returns read only structured array view of `sensor_msgs/PointCloud2`.
+
+    The array references `msg.data`, no per point copy is made. For
+    unorganized clouds (`height == 1`), the array is 1d.
+    """
+    dtype = get_dtype(msg)
+    points = numpy.ndarray(
+        shape=(msg.height, msg.width), dtype=dtype, buffer=msg.data,
+        strides=(msg.row_step, msg.point_step))
+    if msg.height == 1:
+        points = points[0]
+    return points
+
+
+def _decoded_array(n_points, names):
+    return numpy.empty(n_points, dtype=[(name, numpy.float32)
+                                        for name in names])
+
+
+def compact_to_numpy(msg):
+    """Decodes `cepton_ros/CompactPointCloud`.
+
+    Returns structured array with `x`, `y`, `z`, and `intensity` fields.
+    """
+    if msg.encoding == ENCODING_FLOAT16:
+        dtype = numpy.dtype({
+            "names": ["x", "y", "z", "intensity"],
+            "formats": ["<f2"] * 4,
+            "offsets": [0, 2, 4, 6],
+            "itemsize": msg.point_size,
+        })
+        position_scale = 1.0
+        intensity_scale = 1.0
+    elif msg.encoding == ENCODING_INT16:
+        dtype = numpy.dtype({
+            "names": ["x", "y", "z", "intensity"],
+            "formats": ["<i2", "<i2", "<i2", "u1"],
+            "offsets": [0, 2, 4, 6],
+            "itemsize": msg.point_size,
+        })
+        position_scale = msg.scale
+        intensity_scale = msg.intensity_scale
+    else:
+        raise ValueError("Invalid encoding: {}".format(msg.encoding))
+    values = numpy.frombuffer(msg.data, dtype=dtype, count=msg.n_points)
+
+    points = _decoded_array(msg.n_points, ["x", "y", "z", "intensity"])
+    for name in ["x", "y", "z"]:
+        points[name] = values[name] * numpy.float32(position_scale)
+    points["intensity"] = values["intensity"] * numpy.float32(intensity_scale)
+    return points
+
+
+def polar_to_numpy(msg, with_distance=False):
+    """Decodes `cepton_ros/PolarPointCloud`.
+
+    Returns structured array with `image_x`, `image_z`, `x`, `y`, `z`, and
+    `intensity` fields (and `distance`, if `with_distance` is set). Positions
+    are in the sensor frame.
+    """
+    dtype = numpy.dtype({
+        "names": ["image_x", "image_z", "range", "intensity"],
+        "formats": ["<u2", "<u2", "<u2", "u1"],
+        "offsets": [0, 2, 4, 6],
+        "itemsize": 7,
+    })
+    values = numpy.frombuffer(msg.data, dtype=dtype, count=msg.n_points)
+
+    names = ["image_x", "image_z", "x", "y", "z", "intensity"]
+    if with_distance:
+        names.append("distance")
+    points = _decoded_array(msg.n_points, names)
+    image_scale = numpy.float32(msg.image_scale)
+    image_extent = numpy.float32(msg.image_extent)
+    points["image_x"] = values["image_x"] * image_scale - image_extent
+    points["image_z"] = values["image_z"] * image_scale - image_extent
+    points["y"] = values["range"] * numpy.float32(msg.range_scale)
+    points["x"] = -points["image_x"] * points["y"]
+    points["z"] = -points["image_z"] * points["y"]
+    points["intensity"] = values["intensity"] * numpy.float32(1.0 / 255)
+    if with_distance:
+        points["distance"] = numpy.sqrt(
+            points["x"]**2 + points["y"]**2 + points["z"]**2)
+    return points
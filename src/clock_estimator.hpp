@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cepton_ros {
+
+/// Estimates mapping from sensor clock to host clock.
+/**
+ * Host receive time is sensor time plus a variable, always positive,
+ * transport and queueing delay. So `host_time - sensor_time = offset + drift *
+ * (sensor_time - t_0)` is fit to the lower envelope of the samples in a
+ * sliding window (the minimum delay line), instead of by least squares, which
+ * is biased by queueing jitter. The line is the lower convex hull edge that
+ * spans the window center, which minimizes the mean delay above the line (the
+ * usual linear programming fit for one way clock synchronization). Samples
+ * are added once per frame, so the O(window) hull update is negligible.
+ *
+ * Samples below the line, or far above the mean delay, are rejected. If too
+ * many consecutive samples are rejected, the sensor clock is assumed to have
+ * jumped (e.g. GPS/PTP lock), and the estimator is reset.
+ */
+class ClockEstimator {
+ public:
+  void reset() {
+    m_samples.clear();
+    m_i_sample = 0;
+    m_n_rejected = 0;
+    m_offset = 0.0;
+    m_mean_delay = 0.0;
+    offset = 0.0;
+    drift = 0.0;
+    sigma = 0.0;
+  }
+
+  bool is_valid() const { return m_samples.size() >= min_samples; }
+
+  /// Add sample [microseconds].
+  void add_sample(int64_t sensor_time, int64_t host_time) {
+    // Fit relative to first sample, to keep values small
+    if (m_samples.empty() && !m_n_rejected) {
+      m_t_0 = sensor_time;
+      m_offset_0 = host_time - sensor_time;
+    }
+    const double x = 1e-6 * double(sensor_time - m_t_0);
+    const double y = 1e-6 * double(host_time - sensor_time - m_offset_0);
+
+    // Reject outliers
+    if (is_valid()) {
+      const double threshold =
+          std::max(max_sigmas * sigma, min_outlier_threshold);
+      const double delay = y - (m_offset + drift * x);
+      if ((delay < -threshold) || (delay > m_mean_delay + threshold)) {
+        ++m_n_rejected;
+        if (m_n_rejected > window_size / 2) reset();
+        return;
+      }
+    }
+    m_n_rejected = 0;
+
+    // Update window
+    if (m_samples.size() < window_size) {
+      m_samples.emplace_back(x, y);
+    } else {
+      m_samples[m_i_sample] = std::make_pair(x, y);
+      m_i_sample = (m_i_sample + 1) % window_size;
+    }
+    fit();
+  }
+
+  /// Converts sensor time to host time [microseconds].
+  int64_t to_host(int64_t sensor_time) const {
+    const double x = 1e-6 * double(sensor_time - m_t_0);
+    return sensor_time + m_offset_0 + int64_t(1e6 * (m_offset + drift * x));
+  }
+
+ private:
+  void fit() {
+    // Lower convex hull (monotone chain)
+    m_hull = m_samples;
+    std::sort(m_hull.begin(), m_hull.end());
+    std::size_t n_hull = 0;
+    double x_mean = 0.0;
+    for (const auto &sample : m_hull) {
+      x_mean += sample.first;
+      while (n_hull >= 2) {
+        const auto &a = m_hull[n_hull - 2];
+        const auto &b = m_hull[n_hull - 1];
+        const double cross = (b.first - a.first) * (sample.second - a.second) -
+                             (b.second - a.second) * (sample.first - a.first);
+        if (cross > 0.0) break;
+        --n_hull;
+      }
+      m_hull[n_hull++] = sample;
+    }
+    x_mean /= m_samples.size();
+
+    // Hull edge spanning window center
+    drift = 0.0;
+    m_offset = m_hull[0].second;
+    for (std::size_t i = 0; i + 1 < n_hull; ++i) {
+      const auto &a = m_hull[i];
+      const auto &b = m_hull[i + 1];
+      if (b.first <= a.first) continue;
+      drift = (b.second - a.second) / (b.first - a.first);
+      m_offset = a.second - drift * a.first;
+      if (b.first >= x_mean) break;
+    }
+
+    // Delay above line
+    double sum_delay = 0.0;
+    double sum_delay_squared = 0.0;
+    for (const auto &sample : m_samples) {
+      const double delay = sample.second - (m_offset + drift * sample.first);
+      sum_delay += delay;
+      sum_delay_squared += delay * delay;
+    }
+    const double n = m_samples.size();
+    m_mean_delay = sum_delay / n;
+    sigma = std::sqrt(
+        std::max(sum_delay_squared / n - m_mean_delay * m_mean_delay, 0.0));
+    offset = 1e-6 * double(m_offset_0) + m_offset;
+  }
+
+ public:
+  // Options
+  std::size_t window_size = 100;
+  std::size_t min_samples = 10;
+  double max_sigmas = 3.0;
+  double min_outlier_threshold = 1e-3;  ///< [seconds]
+
+  // Outputs
+  double offset = 0.0;  ///< Minimum delay offset at `t_0` [seconds].
+  double drift = 0.0;   ///< [seconds/second]
+  double sigma = 0.0;   ///< Delay standard deviation [seconds].
+
+ private:
+  int64_t m_t_0 = 0;
+  int64_t m_offset_0 = 0;
+  double m_offset = 0.0;
+  double m_mean_delay = 0.0;  ///< Mean delay above line [seconds].
+  std::vector<std::pair<double, double>> m_samples;
+  std::size_t m_i_sample = 0;
+  std::size_t m_n_rejected = 0;
+  /// Hull buffer.
+  std::vector<std::pair<double, double>> m_hull;
+};
+
+}  // namespace cepton_ros
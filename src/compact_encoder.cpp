@@ -0,0 +1,101 @@
+#include "compact_encoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace cepton_ros {
+
+void float_to_half_n(const float *const values, std::size_t n,
+                     uint16_t *const result) {
+  std::size_t i = 0;
+#if defined(__aarch64__)
+  for (; i + 4 <= n; i += 4) {
+    vst1_u16(result + i,
+             vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(values + i))));
+  }
+#elif defined(CEPTON_ROS_HAS_F16C)
+  static const bool has_f16c = __builtin_cpu_supports("f16c");
+  if (has_f16c) {
+    float_to_half_n_f16c(values, n, result);
+    return;
+  }
+#endif
+  for (; i < n; ++i) result[i] = float_to_half(values[i]);
+}
+
+void encode_compact_point_cloud(const CeptonPointCloud &point_cloud,
+                                uint8_t encoding, float resolution,
+                                CompactPointCloud &msg) {
+  msg.encoding = encoding;
+  msg.scale = 0.0f;
+  msg.intensity_scale = 0.0f;
+  msg.n_points = 0;
+  switch (encoding) {
+    case CompactPointCloud::ENCODING_FLOAT16:
+      msg.point_size = 4 * sizeof(uint16_t);
+      break;
+    case CompactPointCloud::ENCODING_INT16: {
+      msg.point_size = 3 * sizeof(int16_t) + sizeof(uint8_t);
+      float max_value = 0.0f;
+      for (const auto &point : point_cloud.points) {
+        if (!point.valid) continue;
+        max_value = std::max(
+            max_value,
+            std::max(std::abs(point.x),
+                     std::max(std::abs(point.y), std::abs(point.z))));
+      }
+      msg.scale = std::max(resolution, max_value / 32767.0f);
+      msg.intensity_scale = 1.0f / 255.0f;
+      break;
+    }
+    default:
+      msg.point_size = 0;
+      msg.data.clear();
+      return;
+  }
+  msg.data.resize(point_cloud.points.size() * msg.point_size);
+
+  uint8_t *data = msg.data.data();
+  if (encoding == CompactPointCloud::ENCODING_FLOAT16) {
+    // Gather valid points, and convert a block at a time
+    constexpr std::size_t block_size = 64;
+    float values[4 * block_size];
+    std::size_t n_values = 0;
+    const auto flush = [&]() {
+      float_to_half_n(values, n_values, (uint16_t *)data);
+      data += n_values * sizeof(uint16_t);
+      msg.n_points += n_values / 4;
+      n_values = 0;
+    };
+    for (const auto &point : point_cloud.points) {
+      if (!point.valid) continue;
+      values[n_values++] = point.x;
+      values[n_values++] = point.y;
+      values[n_values++] = point.z;
+      values[n_values++] = point.intensity;
+      if (n_values == 4 * block_size) flush();
+    }
+    flush();
+  } else {
+    const float scale_inv = 1.0f / msg.scale;
+    for (const auto &point : point_cloud.points) {
+      if (!point.valid) continue;
+      const int16_t result[3] = {int16_t(std::lround(point.x * scale_inv)),
+                                 int16_t(std::lround(point.y * scale_inv)),
+                                 int16_t(std::lround(point.z * scale_inv))};
+      std::memcpy(data, result, sizeof(result));
+      data[sizeof(result)] = uint8_t(
+          std::lround(std::min(std::max(point.intensity, 0.0f), 1.0f) * 255));
+      data += msg.point_size;
+      ++msg.n_points;
+    }
+  }
+  msg.data.resize(msg.n_points * msg.point_size);
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cepton_ros/CompactPointCloud.h"
+#include "cepton_ros/compact_point_cloud.hpp"
+#include "cepton_ros/point.hpp"
+
+namespace cepton_ros {
+
+/// Converts floats to half precision floats, rounding to nearest even.
+/**
+ * Uses F16C if the CPU supports it (checked once at runtime), NEON on
+ * aarch64, and `float_to_half` otherwise.
+ */
+void float_to_half_n(const float *const values, std::size_t n,
+                     uint16_t *const result);
+
+#if defined(CEPTON_ROS_HAS_F16C)
+/// F16C implementation of `float_to_half_n`. Compiled with `-mf16c`, so only
+/// call if the CPU supports F16C.
+void float_to_half_n_f16c(const float *const values, std::size_t n,
+                          uint16_t *const result);
+#endif
+
+/// Encodes valid points.
+/**
+ * For int16 encoding, the scale is `resolution`, unless the points do not fit,
+ * in which case it is increased for this frame.
+ */
+void encode_compact_point_cloud(const CeptonPointCloud &point_cloud,
+                                uint8_t encoding, float resolution,
+                                CompactPointCloud &msg);
+
+}  // namespace cepton_ros
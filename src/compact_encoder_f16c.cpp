@@ -0,0 +1,20 @@
+#include "compact_encoder.hpp"
+
+#if defined(CEPTON_ROS_HAS_F16C)
+#include <immintrin.h>
+
+namespace cepton_ros {
+
+void float_to_half_n_f16c(const float *const values, std::size_t n,
+                          uint16_t *const result) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128i h =
+        _mm_cvtps_ph(_mm_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storel_epi64((__m128i *)(result + i), h);
+  }
+  for (; i < n; ++i) result[i] = float_to_half(values[i]);
+}
+
+}  // namespace cepton_ros
+#endif
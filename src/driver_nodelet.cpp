@@ -1,12 +1,56 @@
 #include "driver_nodelet.hpp"
 
+#include <cmath>
+#include <sstream>
+
 #include <pluginlib/class_list_macros.h>
+#include <ros/publication.h>
+#include <ros/topic_manager.h>
 
 PLUGINLIB_EXPORT_CLASS(cepton_ros::DriverNodelet, nodelet::Nodelet);
 
 namespace cepton_ros {
 
-DriverNodelet::~DriverNodelet() { cepton_sdk_deinitialize(); }
+namespace {
+/// Returns per sensor file path in directory.
+std::string get_sensor_path(const std::string &directory,
+                            const std::string &name, uint64_t serial_number) {
+  return directory + "/" + name + "_" + std::to_string(serial_number) + ".bin";
+}
+
+/// Returns true if any subscriber receives a serialized copy of messages
+/// (remote subscribers, or intraprocess subscribers of a different type).
+template <typename T>
+bool has_serialized_subscribers(const ros::Publisher &publisher) {
+  const auto publication =
+      ros::TopicManager::instance()->lookupPublication(publisher.getTopic());
+  if (!publication) return false;
+  bool serialize = false;
+  bool nocopy = false;
+  publication->getPublishTypes(serialize, nocopy, typeid(T));
+  return serialize;
+}
+}  // namespace
+
+DriverNodelet::~DriverNodelet() {
+  {
+    std::lock_guard<std::mutex> lock(lockstep_mutex);
+    capture_running = false;
+  }
+  lockstep_condition_variable.notify_all();
+  if (capture_thread.joinable()) capture_thread.join();
+  capture_replay.close();
+  if (background_subtraction && !background_path.empty()) {
+    std::lock_guard<std::mutex> lock(sensors_mutex);
+    for (const auto &iter : sensors) {
+      auto &sensor = *iter.second;
+      std::lock_guard<std::mutex> sensor_lock(sensor.mutex);
+      sensor.background_model.save(get_sensor_path(
+          background_path, "background", sensor.serial_number));
+    }
+  }
+  cepton_sdk_deinitialize();
+}
 
 const std::map<std::string, cepton_sdk::FrameMode> frame_mode_lut = {
     {"COVER", CEPTON_SDK_FRAME_COVER},
@@ -14,7 +58,22 @@ const std::map<std::string, cepton_sdk::FrameMode> frame_mode_lut = {
     {"STREAMING", CEPTON_SDK_FRAME_TIMED},
 };
 
+const std::map<std::string, uint8_t> compact_encoding_lut = {
+    {"FLOAT16", CompactPointCloud::ENCODING_FLOAT16},
+    {"INT16", CompactPointCloud::ENCODING_INT16},
+};
+
+const std::map<std::string, uint32_t> output_stream_lut = {
+    {"compact", DriverNodelet::OUTPUT_COMPACT},
+    {"delta", DriverNodelet::OUTPUT_DELTA},
+    {"latest_frame", DriverNodelet::OUTPUT_LATEST_FRAME},
+    {"points", DriverNodelet::OUTPUT_POINTS},
+    {"polar", DriverNodelet::OUTPUT_POLAR},
+    {"progressive", DriverNodelet::OUTPUT_PROGRESSIVE},
+};
+
 void DriverNodelet::onInit() {
+  init_time = ros::WallTime::now();
   this->node_handle = getNodeHandle();
   this->private_node_handle = getPrivateNodeHandle();
 
@@ -27,18 +86,192 @@ void DriverNodelet::onInit() {
 
   std::string capture_path = "";
   private_node_handle.param("capture_path", capture_path, capture_path);
+  std::vector<std::string> capture_paths;
+  {
+    std::stringstream capture_path_stream(capture_path);
+    std::string path;
+    while (std::getline(capture_path_stream, path, ',')) {
+      if (!path.empty()) capture_paths.push_back(path);
+    }
+  }
 
   int control_flags = 0;
   private_node_handle.param("control_flags", control_flags, control_flags);
 
+  private_node_handle.param("lockstep", lockstep, lockstep);
+  private_node_handle.param("lockstep_consumers", lockstep_consumers,
+                            lockstep_consumers);
+  private_node_handle.param("lockstep_timeout", lockstep_timeout,
+                            lockstep_timeout);
+  bool publish_clock = lockstep;
+  private_node_handle.param("publish_clock", publish_clock, publish_clock);
+
   std::string frame_mode_str = "CYCLE";
   private_node_handle.param("frame_mode", frame_mode_str, frame_mode_str);
   const cepton_sdk::FrameMode frame_mode = frame_mode_lut.at(frame_mode_str);
 
+  private_node_handle.param("sensor_timeout", sensor_timeout, sensor_timeout);
+  private_node_handle.param("clock_correction", clock_correction,
+                            clock_correction);
+  private_node_handle.param("grid_extent", grid_extent, grid_extent);
+  private_node_handle.param("occlusion_mask_path", occlusion_mask_path,
+                            occlusion_mask_path);
+  private_node_handle.param("occlusion_mask_calibrate",
+                            occlusion_mask_calibrate,
+                            occlusion_mask_calibrate);
+  private_node_handle.param("occlusion_mask_max_distance",
+                            occlusion_mask_max_distance,
+                            occlusion_mask_max_distance);
+  private_node_handle.param("temporal_filter", temporal_filter,
+                            temporal_filter);
+  private_node_handle.param("temporal_filter_max_distance",
+                            temporal_filter_max_distance,
+                            temporal_filter_max_distance);
+  private_node_handle.param("temporal_filter_max_intensity",
+                            temporal_filter_max_intensity,
+                            temporal_filter_max_intensity);
+  private_node_handle.param("background_subtraction", background_subtraction,
+                            background_subtraction);
+  private_node_handle.param("background_path", background_path,
+                            background_path);
+  private_node_handle.param("background_learning_frames",
+                            background_learning_frames,
+                            background_learning_frames);
+  std::string outlier_filter_str = "";
+  private_node_handle.param("outlier_filter", outlier_filter_str,
+                            outlier_filter_str);
+  {
+    std::stringstream outlier_filter_stream(outlier_filter_str);
+    std::string stream;
+    while (std::getline(outlier_filter_stream, stream, ',')) {
+      if (!stream.empty())
+        outlier_filter_streams |= output_stream_lut.at(stream);
+    }
+  }
+  private_node_handle.param("outlier_filter_radius", outlier_filter_radius,
+                            outlier_filter_radius);
+  private_node_handle.param("outlier_filter_min_neighbors",
+                            outlier_filter_min_neighbors,
+                            outlier_filter_min_neighbors);
+  private_node_handle.param("outlier_filter_std_ratio",
+                            outlier_filter_std_ratio, outlier_filter_std_ratio);
+  std::string compact_encoding_str = "";
+  private_node_handle.param("compact_encoding", compact_encoding_str,
+                            compact_encoding_str);
+  if (!compact_encoding_str.empty())
+    compact_encoding = compact_encoding_lut.at(compact_encoding_str);
+  private_node_handle.param("compact_resolution", compact_resolution,
+                            compact_resolution);
+  private_node_handle.param("publish_polar", publish_polar, publish_polar);
+  private_node_handle.param("polar_resolution", polar_resolution,
+                            polar_resolution);
+  private_node_handle.param("publish_progressive", publish_progressive,
+                            publish_progressive);
+  private_node_handle.param("progressive_layers", progressive_layers,
+                            progressive_layers);
+  progressive_layers = std::min(std::max(progressive_layers, 1), 16);
+  private_node_handle.param("progressive_max_bytes", progressive_max_bytes,
+                            progressive_max_bytes);
+  private_node_handle.param("publish_delta", publish_delta, publish_delta);
+  private_node_handle.param("delta_keyframe_interval", delta_keyframe_interval,
+                            delta_keyframe_interval);
+  private_node_handle.param("delta_max_distance", delta_max_distance,
+                            delta_max_distance);
+  private_node_handle.param("delta_max_intensity", delta_max_intensity,
+                            delta_max_intensity);
+  private_node_handle.param("perf_counters", perf_counters, perf_counters);
+  private_node_handle.param("multicast_group", multicast_group,
+                            multicast_group);
+  int multicast_port = 7510;
+  private_node_handle.param("multicast_port", multicast_port, multicast_port);
+  int multicast_ttl = 1;
+  private_node_handle.param("multicast_ttl", multicast_ttl, multicast_ttl);
+  int multicast_mtu = 1500;
+  private_node_handle.param("multicast_mtu", multicast_mtu, multicast_mtu);
+  std::string multicast_interface = "";
+  private_node_handle.param("multicast_interface", multicast_interface,
+                            multicast_interface);
+  float multicast_rate = 0.0f;
+  private_node_handle.param("multicast_rate", multicast_rate, multicast_rate);
+  multicast_sender.max_rate = 1e6 / 8 * multicast_rate;
+  private_node_handle.param("publish_statistics", publish_statistics,
+                            publish_statistics);
+  private_node_handle.param("latest_frame_service", latest_frame_service,
+                            latest_frame_service);
+  private_node_handle.param("publish_chunks", publish_chunks, publish_chunks);
+  private_node_handle.param("chunk_size", chunk_size, chunk_size);
+
+  std::string transforms_path = "";
+  private_node_handle.param("transforms_path", transforms_path,
+                            transforms_path);
+  bool apply_transforms = false;
+  private_node_handle.param("apply_transforms", apply_transforms,
+                            apply_transforms);
+  private_node_handle.param("parent_frame_id", parent_frame_id,
+                            parent_frame_id);
+  if (apply_transforms && !transforms_path.empty())
+    transforms_watcher.start(transforms_path);
+  std::string target_frame = "";
+  private_node_handle.param("target_frame", target_frame, target_frame);
+  bool target_frame_fixed = true;
+  private_node_handle.param("target_frame_fixed", target_frame_fixed,
+                            target_frame_fixed);
+  if (!target_frame.empty())
+    target_frame_lookup.start(target_frame, target_frame_fixed);
+
+  std::string cameras_path = "";
+  private_node_handle.param("cameras_path", cameras_path, cameras_path);
+  if (!cameras_path.empty()) {
+    // Each camera has one transform, so points must share a frame
+    std::string points_frame_id;
+    if (!target_frame.empty())
+      points_frame_id = target_frame;
+    else if (apply_transforms && !transforms_path.empty())
+      points_frame_id = parent_frame_id;
+    init_cameras(cameras_path, points_frame_id);
+  }
+
   sensor_info_publisher =
       node_handle.advertise<SensorInformation>("cepton/sensor_information", 2);
   points_publisher =
       node_handle.advertise<CeptonPointCloud>("cepton/points", 2);
+  if (publish_statistics)
+    statistics_publisher = node_handle.advertise<FrameStatistics>(
+        "cepton/frame_statistics", 2);
+  if (publish_chunks)
+    chunks_publisher =
+        node_handle.advertise<PointCloudChunk>("cepton/points_chunks", 100);
+  if (!compact_encoding_str.empty())
+    compact_points_publisher = node_handle.advertise<CompactPointCloud>(
+        "cepton/points_compact", 2);
+  if (publish_polar)
+    polar_points_publisher =
+        node_handle.advertise<PolarPointCloud>("cepton/points_polar", 2);
+  if (publish_progressive)
+    progressive_publisher = node_handle.advertise<ProgressiveLayer>(
+        "cepton/points_progressive", 2 * progressive_layers);
+  if (perf_counters) {
+    if (PerfCounters().open()) {
+      pipeline_counters_publisher = node_handle.advertise<PipelineCounters>(
+          "cepton/pipeline_counters", 2);
+    } else {
+      NODELET_WARN("Failed to open performance counters.");
+      perf_counters = false;
+    }
+  }
+  if (!multicast_group.empty() &&
+      !multicast_sender.open(multicast_group, multicast_port, multicast_ttl,
+                             multicast_interface, multicast_mtu))
+    NODELET_WARN("Failed to open multicast group %s:%d.",
+                 multicast_group.c_str(), multicast_port);
+  if (publish_delta)
+    delta_publisher =
+        node_handle.advertise<DeltaFrame>("cepton/points_delta", 2);
+  if (latest_frame_service)
+    get_latest_frame_service = node_handle.advertiseService(
+        "cepton/get_latest_frame", &DriverNodelet::on_get_latest_frame, this);
+  if (publish_clock)
+    clock_publisher = node_handle.advertise<rosgraph_msgs::Clock>("/clock", 2);
 
   // Initialize sdk
   cepton_sdk::SensorError error;
@@ -52,31 +285,147 @@ void DriverNodelet::onInit() {
 
   auto options = cepton_sdk::create_options();
   options.control_flags = control_flags;
-  if (!capture_path.empty())
+  if (!capture_paths.empty())
     options.control_flags |= CEPTON_SDK_CONTROL_DISABLE_NETWORK;
   options.frame.mode = frame_mode;
   if (frame_mode == CEPTON_SDK_FRAME_TIMED) options.frame.length = 0.01f;
+  frame_options = options.frame;
+  // Detect frames in driver, so that chunks can be published as points arrive
+  if (publish_chunks) options.frame.mode = CEPTON_SDK_FRAME_STREAMING;
   error = cepton_sdk::initialize(
       CEPTON_SDK_VERSION, options,
       &cepton_sdk::api::SensorErrorCallback::global_on_callback,
       &error_callback);
   FATAL_ERROR(error);
 
-  // Start capture
-  if (!capture_path.empty()) {
-    error = cepton_sdk::api::open_replay(capture_path);
-    FATAL_ERROR(error);
-    error = cepton_sdk::capture_replay::set_enable_loop(capture_loop);
-    FATAL_ERROR(error);
-    error = cepton_sdk::capture_replay::resume();
-    FATAL_ERROR(error);
-  }
-
   // Listen
+  liveness_timer = node_handle.createWallTimer(
+      ros::WallDuration(0.5 * sensor_timeout),
+      &DriverNodelet::on_liveness_timer, this);
   error = image_frame_callback.initialize();
   FATAL_ERROR(error);
   error = image_frame_callback.listen(this, &DriverNodelet::on_image_points);
   FATAL_ERROR(error);
+
+  // Start capture in background, since opening and indexing can be slow
+  if (!capture_paths.empty()) {
+    if (lockstep && (lockstep_consumers > 0)) {
+      ack_subscriber = node_handle.subscribe<std_msgs::Header>(
+          "cepton/ack", 100, &DriverNodelet::on_ack, this);
+    }
+    capture_running = true;
+    capture_thread = std::thread([this, capture_paths, capture_loop]() {
+      start_capture(capture_paths, capture_loop);
+    });
+  }
+}
+
+void DriverNodelet::init_cameras(const std::string &path,
+                                 const std::string &points_frame_id) {
+  std::vector<CameraConfig> camera_configs;
+  if (!load_cameras(path, camera_configs)) return;
+  for (const auto &camera_config : camera_configs) {
+    const std::string frame_id = (camera_config.frame_id.empty())
+                                     ? points_frame_id
+                                     : camera_config.frame_id;
+    if (frame_id.empty()) {
+      NODELET_WARN(
+          "Camera %s disabled: points are in per sensor frames. Set its "
+          "\"frame\", or set apply_transforms or target_frame.",
+          camera_config.name.c_str());
+      continue;
+    }
+    cameras.emplace_back(new Camera());
+    auto &camera = *cameras.back();
+    camera.name = camera_config.name;
+    camera.frame_id = frame_id;
+    camera.depth_image.transform = camera_config.transform;
+    camera.depth_publisher = node_handle.advertise<sensor_msgs::Image>(
+        "cepton/cameras/" + camera_config.name + "/depth", 2);
+    camera.camera_info_subscriber =
+        node_handle.subscribe<sensor_msgs::CameraInfo>(
+            camera_config.camera_info_topic, 2,
+            boost::function<void(const sensor_msgs::CameraInfo::ConstPtr &)>(
+                [this, &camera](const sensor_msgs::CameraInfo::ConstPtr &msg) {
+                  on_camera_info(camera, msg);
+                }));
+  }
+}
+
+void DriverNodelet::on_camera_info(
+    Camera &camera, const sensor_msgs::CameraInfo::ConstPtr &msg) {
+  sensor_msgs::ImageConstPtr image;
+  {
+    std::lock_guard<std::mutex> lock(camera.mutex);
+    if (!camera.depth_image.empty())
+      image = camera.depth_image.finish(msg->header);
+    camera.depth_image.set_camera_info(*msg);
+  }
+  if (image) camera.depth_publisher.publish(image);
+}
+
+void DriverNodelet::start_capture(const std::vector<std::string> &paths,
+                                  bool loop) {
+  cepton_sdk::SensorError error;
+  error = capture_replay.open(paths);
+  FATAL_ERROR(error);
+  error = capture_replay.set_enable_loop(loop);
+  FATAL_ERROR(error);
+  NODELET_INFO("Opened capture in %.3f s.",
+               (ros::WallTime::now() - init_time).toSec());
+
+  if (lockstep) {
+    run_lockstep();
+    return;
+  }
+
+  error = capture_replay.resume();
+  FATAL_ERROR(error);
+
+  pause_replay_service = node_handle.advertiseService(
+      "cepton/replay/pause", &DriverNodelet::on_pause_replay, this);
+  resume_replay_service = node_handle.advertiseService(
+      "cepton/replay/resume", &DriverNodelet::on_resume_replay, this);
+  seek_replay_service = node_handle.advertiseService(
+      "cepton/replay/seek", &DriverNodelet::on_seek_replay, this);
+  step_replay_service = node_handle.advertiseService(
+      "cepton/replay/step", &DriverNodelet::on_step_replay, this);
+  set_replay_rate_service = node_handle.advertiseService(
+      "cepton/replay/set_rate", &DriverNodelet::on_set_replay_rate, this);
+}
+
+bool DriverNodelet::on_get_latest_frame(GetLatestFrame::Request &request,
+                                        GetLatestFrame::Response &response) {
+  std::vector<std::shared_ptr<SensorState>> sensors_tmp;
+  {
+    std::lock_guard<std::mutex> lock(sensors_mutex);
+    for (const auto &iter : sensors) {
+      if (request.serial_number && (iter.first != request.serial_number))
+        continue;
+      sensors_tmp.push_back(iter.second);
+    }
+  }
+
+  // Find latest frame. Does not block frame processing.
+  std::lock_guard<std::mutex> lock(latest_frame_mutex);
+  const CeptonPointCloud *point_cloud = nullptr;
+  for (const auto &sensor : sensors_tmp) {
+    auto &latest_frame = sensor->latest_frame;
+    latest_frame.update();
+    if (!latest_frame.has_value()) continue;
+    const auto &frame = latest_frame.get_read_buffer();
+    if (point_cloud && (frame.header.stamp <= point_cloud->header.stamp))
+      continue;
+    point_cloud = &frame;
+    response.serial_number = sensor->serial_number;
+  }
+  response.success = (point_cloud != nullptr);
+  if (!point_cloud) {
+    response.message = "No frames found";
+    return true;
+  }
+  pcl::toROSMsg(*point_cloud, response.points);
+  return true;
 }
 
 void DriverNodelet::on_image_points(
@@ -91,13 +440,247 @@ void DriverNodelet::on_image_points(
   publish_sensor_information(sensor_info);
 
   // Publish points
-  image_points.reserve(n_points);
-  for (std::size_t i = 0; i < n_points; ++i) {
-    image_points.push_back(c_image_points[i]);
+  const auto sensor = attach_sensor(sensor_info);
+  std::lock_guard<std::mutex> sensor_lock(sensor->mutex);
+  if (!sensor->point_cloud) sensor->point_cloud = point_cloud_pool->get();
+  if (publish_chunks) {
+    add_chunk_points(*sensor, sensor_info, n_points, c_image_points);
+    return;
+  }
+  publish_points(*sensor, n_points, c_image_points);
+}
+
+std::shared_ptr<SensorState> DriverNodelet::attach_sensor(
+    const cepton_sdk::SensorInformation &sensor_info) {
+  std::lock_guard<std::mutex> lock(sensors_mutex);
+  auto &sensor = sensors[sensor_info.serial_number];
+  if (!sensor) {
+    NODELET_INFO("Sensor %lu connected.",
+                 (unsigned long)sensor_info.serial_number);
+    sensor = std::make_shared<SensorState>();
+    sensor->serial_number = sensor_info.serial_number;
+    sensor->frame_id =
+        (combine_sensors)
+            ? "cepton_0"
+            : ("cepton_" + std::to_string(sensor_info.serial_number));
+    for (ImageGrid *const grid :
+         {&sensor->occlusion_mask.grid, &sensor->temporal_filter.grid,
+          &sensor->outlier_filter.grid, &sensor->background_model.grid,
+          &sensor->delta_encoder.grid})
+      *grid = ImageGrid(grid->resolution, grid_extent);
+    sensor->occlusion_mask.max_distance = occlusion_mask_max_distance;
+    if (occlusion_mask_calibrate) {
+      NODELET_INFO("Sensor %lu occlusion mask calibration started.",
+                   (unsigned long)sensor->serial_number);
+      sensor->occlusion_mask.start_calibration();
+    } else if (!occlusion_mask_path.empty()) {
+      const std::string path = get_sensor_path(
+          occlusion_mask_path, "occlusion_mask", sensor->serial_number);
+      if (sensor->occlusion_mask.load(path))
+        NODELET_INFO("Loaded occlusion mask %s.", path.c_str());
+    }
+    sensor->temporal_filter.max_distance = temporal_filter_max_distance;
+    sensor->temporal_filter.max_intensity = temporal_filter_max_intensity;
+    sensor->background_model.learning_frames = background_learning_frames;
+  } else if (!sensor->is_alive) {
+    NODELET_INFO("Sensor %lu reconnected.",
+                 (unsigned long)sensor_info.serial_number);
+    // Sensor clock may have been reset
+    std::lock_guard<std::mutex> sensor_lock(sensor->mutex);
+    sensor->clock_estimator.reset();
+  }
+  // Background model is released when sensor times out
+  if (!sensor->is_alive && background_subtraction &&
+      !background_path.empty()) {
+    const std::string path = get_sensor_path(
+        background_path, "background", sensor->serial_number);
+    std::lock_guard<std::mutex> sensor_lock(sensor->mutex);
+    if (sensor->background_model.load(path))
+      NODELET_INFO("Loaded background model %s.", path.c_str());
+  }
+  // Kernels and frame detector depend on geometry, which may change on
+  // reattach
+  if ((sensor->segment_count != sensor_info.segment_count) ||
+      (sensor->return_count != sensor_info.return_count)) {
+    std::lock_guard<std::mutex> sensor_lock(sensor->mutex);
+    sensor->segment_count = sensor_info.segment_count;
+    sensor->return_count = sensor_info.return_count;
+    sensor->kernels = &get_point_kernels(sensor->segment_count,
+                                         sensor->return_count);
+    sensor->reset_chunks();
+    sensor->frame_detector.reset();
   }
-  publish_points(sensor_info.serial_number);
-  image_points.clear();
-  points.clear();
+  sensor->handle = sensor_info.handle;
+  sensor->is_alive = true;
+  sensor->last_frame_time = ros::WallTime::now();
+  return sensor;
+}
+
+void DriverNodelet::on_liveness_timer(const ros::WallTimerEvent &event) {
+  // Paused replay is not a disconnect
+  if (capture_replay.is_open() &&
+      (lockstep || !capture_replay.is_running()))
+    return;
+
+  const ros::WallTime now = ros::WallTime::now();
+  std::lock_guard<std::mutex> lock(sensors_mutex);
+  for (auto &iter : sensors) {
+    auto &sensor = *iter.second;
+    if (!sensor.is_alive) continue;
+    if ((now - sensor.last_frame_time).toSec() < sensor_timeout) continue;
+
+    // Frame in progress, retry on next tick
+    std::unique_lock<std::mutex> sensor_lock(sensor.mutex, std::try_to_lock);
+    if (!sensor_lock.owns_lock()) continue;
+    NODELET_WARN("Sensor %lu disconnected.",
+                 (unsigned long)sensor.serial_number);
+    sensor.is_alive = false;
+
+    // Release buffers. Background model is reloaded on reconnect.
+    if (background_subtraction && !background_path.empty())
+      sensor.background_model.save(get_sensor_path(
+          background_path, "background", sensor.serial_number));
+    sensor.release_buffers();
+    // Sensor clock may have been reset
+    sensor.clock_estimator.reset();
+    {
+      // Do not serve stale frames
+      std::lock_guard<std::mutex> latest_frame_lock(latest_frame_mutex);
+      sensor.latest_frame.reset();
+    }
+  }
+}
+
+void DriverNodelet::on_ack(const std_msgs::Header::ConstPtr &msg) {
+  {
+    std::lock_guard<std::mutex> lock(lockstep_mutex);
+    const int64_t stamp =
+        int64_t(msg->stamp.sec) * 1000000 + int64_t(msg->stamp.nsec / 1000);
+    if ((stamp != lockstep_stamp) ||
+        (msg->frame_id != lockstep_frame_id))
+      return;
+    ++n_acks;
+  }
+  lockstep_condition_variable.notify_all();
+}
+
+void DriverNodelet::run_lockstep() {
+  cepton_sdk::SensorError error;
+  while (capture_running) {
+    // Replay until next frame is published
+    const uint64_t n_frames_start = n_frames;
+    while (capture_running && (n_frames == n_frames_start)) {
+      error = capture_replay.resume_blocking_once();
+      if (error) break;
+    }
+    if (error) {
+      if (error.code == CEPTON_ERROR_EOF)
+        NODELET_INFO("Lockstep replay finished.");
+      else
+        NODELET_WARN(error.what());
+      break;
+    }
+
+    // Wait for consumers
+    if (lockstep_consumers > 0) {
+      std::unique_lock<std::mutex> lock(lockstep_mutex);
+      const auto is_done = [this]() {
+        return !capture_running || (n_acks >= lockstep_consumers);
+      };
+      if (lockstep_timeout > 0.0f) {
+        if (!lockstep_condition_variable.wait_for(
+                lock,
+                std::chrono::microseconds(
+                    cepton_sdk::util::to_usec(lockstep_timeout)),
+                is_done))
+          NODELET_WARN("Lockstep ack timeout (%i/%i).", n_acks,
+                       lockstep_consumers);
+      } else {
+        lockstep_condition_variable.wait(lock, is_done);
+      }
+    } else {
+      // Wait until all subscribers have released the published cloud. Only
+      // intraprocess subscribers share it.
+      if (has_serialized_subscribers<CeptonPointCloud>(points_publisher))
+        NODELET_WARN_THROTTLE(
+            10.0,
+            "Lockstep does not wait for remote subscribers (set "
+            "lockstep_consumers).");
+      const auto t_start = std::chrono::steady_clock::now();
+      while (capture_running && !lockstep_cloud.expired()) {
+        if ((lockstep_timeout > 0.0f) &&
+            (std::chrono::steady_clock::now() - t_start >
+             std::chrono::microseconds(
+                 cepton_sdk::util::to_usec(lockstep_timeout))))
+          break;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    }
+  }
+}
+
+bool DriverNodelet::on_pause_replay(std_srvs::Trigger::Request &request,
+                                    std_srvs::Trigger::Response &response) {
+  const auto error = capture_replay.pause();
+  response.success = !error;
+  response.message = error.what();
+  return true;
+}
+
+bool DriverNodelet::on_resume_replay(std_srvs::Trigger::Request &request,
+                                     std_srvs::Trigger::Response &response) {
+  const auto error = capture_replay.resume();
+  response.success = !error;
+  response.message = error.what();
+  return true;
+}
+
+bool DriverNodelet::on_seek_replay(SeekReplay::Request &request,
+                                   SeekReplay::Response &response) {
+  const auto error = capture_replay.seek(request.position);
+  response.success = !error;
+  response.message = error.what();
+  return true;
+}
+
+bool DriverNodelet::on_step_replay(StepReplay::Request &request,
+                                   StepReplay::Response &response) {
+  cepton_sdk::SensorError error = capture_replay.pause();
+
+  // Replay packets until enough frames are emitted. Stop at end of capture,
+  // or if no frames are emitted for `sensor_timeout` of capture time (e.g.
+  // there are no sensors).
+  const uint64_t n_frames_end = n_frames + request.n_frames;
+  const int64_t max_idle_time = cepton_sdk::util::to_usec(sensor_timeout);
+  uint64_t n_frames_prev = n_frames;
+  int64_t t_prev = capture_replay.get_time();
+  int64_t idle_time = 0;
+  while (!error && (n_frames < n_frames_end)) {
+    error = capture_replay.resume_blocking_once();
+    const int64_t t = capture_replay.get_time();
+    if (n_frames != n_frames_prev) {
+      n_frames_prev = n_frames;
+      idle_time = 0;
+    } else if (t > t_prev) {
+      // Time goes backwards on loop
+      idle_time += t - t_prev;
+    }
+    t_prev = t;
+    if (!error && (idle_time > max_idle_time))
+      error = cepton_sdk::SensorError(CEPTON_ERROR_GENERIC, "No frames found");
+  }
+  response.success = !error;
+  response.message = error.what();
+  response.position = capture_replay.get_position();
+  return true;
+}
+
+bool DriverNodelet::on_set_replay_rate(SetReplayRate::Request &request,
+                                       SetReplayRate::Response &response) {
+  const auto error = capture_replay.set_speed(request.rate);
+  response.success = !error;
+  response.message = error.what();
+  return true;
 }
 
 void DriverNodelet::publish_sensor_information(
@@ -143,27 +726,515 @@ void DriverNodelet::publish_sensor_information(
   sensor_info_publisher.publish(msg);
 }
 
-void DriverNodelet::publish_points(uint64_t serial_number) {
-  // Convert image points to points
-  points.clear();
-  points.resize(image_points.size());
-  for (int i = 0; i < image_points.size(); ++i) {
-    cepton_sdk::util::convert_sensor_image_point_to_point(image_points[i],
-                                                          points[i]);
+void DriverNodelet::publish_points(
+    SensorState &sensor, std::size_t n_points,
+    const cepton_sdk::SensorImagePoint *const c_image_points) {
+  update_clock(sensor, n_points, c_image_points);
+  sensor.statistics.clear();
+  sensor.stage_counters.clear();
+  if (convert_points(sensor, n_points, c_image_points, *sensor.point_cloud))
+    publish_frame(sensor);
+  ++sensor.frame_index;
+}
+
+void DriverNodelet::publish_frame(SensorState &sensor) {
+  finish_frame(sensor);
+  publish_progressive_layers(sensor);
+  publish_point_cloud(sensor);
+  send_multicast_points(sensor);
+  publish_compact_points(sensor);
+  publish_polar_points(sensor);
+  publish_delta_frame(sensor);
+  publish_frame_statistics(sensor);
+  cache_latest_frame(sensor);
+  publish_pipeline_counters(sensor);
+}
+
+void DriverNodelet::add_chunk_points(
+    SensorState &sensor, const cepton_sdk::SensorInformation &sensor_info,
+    std::size_t n_points,
+    const cepton_sdk::SensorImagePoint *const c_image_points) {
+  if (!sensor.frame_detector) {
+    sensor.frame_detector.reset(
+        new cepton_sdk::util::FrameDetector(sensor_info));
+    const auto error = sensor.frame_detector->set_options(frame_options);
+    WARN_ERROR(error);
+  }
+  auto &image_points = sensor.image_points;
+  const int stride =
+      std::max(sensor_info.return_count * sensor_info.segment_count, 1);
+
+  const int i_0 = image_points.size();
+  {
+    StageScope scope(get_stage_counters(sensor), STAGE_COPY);
+    image_points.insert(image_points.end(), c_image_points,
+                        c_image_points + n_points);
   }
+  for (int i = i_0;; i += stride) {
+    i = sensor.kernels->find_frame(*sensor.frame_detector, image_points.data(),
+                                   i, int(image_points.size()), stride);
+    if (i < 0) break;
+
+    // Frame boundary may be in a chunk that was already published. In that
+    // case, end frame at end of published points instead.
+    const int i_detected =
+        sensor.frame_detector->frame_idx * stride - sensor.frame_offset;
+    const int i_end = std::max(i_detected, int(sensor.n_chunk_points));
+    sensor.frame_offset = i_end - i_detected;
+
+    update_clock(sensor, i_end, image_points.data());
+    if (publish_chunk(sensor, sensor.n_chunk_points, i_end, true))
+      publish_frame(sensor);
+    // Stages of next frame, starting with the next copy. The copy of the
+    // boundary chunk was counted in the frame that ended.
+    sensor.stage_counters.clear();
+
+    image_points.erase(image_points.begin(), image_points.begin() + i_end);
+    i -= i_end;
+    sensor.n_chunk_points = 0;
+    ++sensor.frame_index;
+    sensor.chunk_index = 0;
+  }
+
+  if (image_points.size() - sensor.n_chunk_points >= std::size_t(chunk_size)) {
+    publish_chunk(sensor, sensor.n_chunk_points, image_points.size(), false);
+    sensor.n_chunk_points = image_points.size();
+  }
+}
+
+bool DriverNodelet::publish_chunk(SensorState &sensor, std::size_t i_start,
+                                  std::size_t i_end, bool is_last) {
+  auto &chunk_point_cloud = sensor.chunk_point_cloud;
+  if (sensor.chunk_index == 0) {
+    sensor.statistics.clear();
+    sensor.is_frame_dropped = false;
+  }
+  if (!convert_points(sensor, i_end - i_start,
+                      sensor.image_points.data() + i_start,
+                      chunk_point_cloud)) {
+    // Skip chunk index, so that receivers drop frame too
+    sensor.is_frame_dropped = true;
+    ++sensor.chunk_index;
+    return false;
+  }
+
+  // Append to frame
+  auto &point_cloud = *sensor.point_cloud;
+  if (sensor.chunk_index == 0) {
+    point_cloud.clear();
+    point_cloud.header = chunk_point_cloud.header;
+  }
+  if (!chunk_point_cloud.empty()) point_cloud.header = chunk_point_cloud.header;
+  point_cloud.points.insert(point_cloud.points.end(),
+                            chunk_point_cloud.points.begin(),
+                            chunk_point_cloud.points.end());
+  point_cloud.height = 1;
+  point_cloud.width = point_cloud.points.size();
+
+  PointCloudChunk msg;
+  msg.header = pcl_conversions::fromPCL(chunk_point_cloud.header);
+  msg.serial_number = sensor.serial_number;
+  msg.frame_index = sensor.frame_index;
+  msg.chunk_index = sensor.chunk_index;
+  msg.is_last = is_last;
+  {
+    StageScope scope(get_stage_counters(sensor), STAGE_SERIALIZE);
+    pcl::toROSMsg(chunk_point_cloud, msg.points);
+  }
+  {
+    StageScope scope(get_stage_counters(sensor), STAGE_PUBLISH);
+    chunks_publisher.publish(msg);
+  }
+  ++sensor.chunk_index;
+  return !sensor.is_frame_dropped;
+}
+
+void DriverNodelet::update_clock(
+    SensorState &sensor, std::size_t n_points,
+    const cepton_sdk::SensorImagePoint *const c_image_points) {
+  if (n_points == 0) return;
+  // In replay, the capture timestamp is the host receive time.
+  const int64_t host_time = (capture_replay.is_open())
+                                ? capture_replay.get_time()
+                                : cepton_sdk::util::get_timestamp_usec();
+  sensor.clock_estimator.add_sample(c_image_points[n_points - 1].timestamp,
+                                    host_time);
+}
+
+bool DriverNodelet::convert_points(
+    SensorState &sensor, std::size_t n_points,
+    const cepton_sdk::SensorImagePoint *const c_image_points,
+    CeptonPointCloud &point_cloud) {
+  // Lookup transform. Reloads are picked up on next frame.
+  const auto transforms = transforms_watcher.get();
+  cepton_sdk::util::CompiledTransform transform;
+  transform.translation.fill(0.0f);
+  bool has_transform = false;
+  if (transforms) {
+    const auto iter = transforms->find(sensor.serial_number);
+    if (iter != transforms->end()) {
+      transform = iter->second;
+      has_transform = true;
+    }
+  }
+
+  const auto &clock_estimator = sensor.clock_estimator;
+  const bool correct_clock = clock_correction && clock_estimator.is_valid();
 
   point_cloud.clear();
-  point_cloud.header.stamp = rosutil::to_usec(ros::Time::now());
+  if (correct_clock && (n_points > 0)) {
+    point_cloud.header.stamp =
+        clock_estimator.to_host(c_image_points[n_points - 1].timestamp);
+  } else if (lockstep && (n_points > 0)) {
+    // In lockstep mode, stamp with capture time, so that output is
+    // deterministic.
+    point_cloud.header.stamp = c_image_points[n_points - 1].timestamp;
+  } else {
+    point_cloud.header.stamp = rosutil::to_usec(ros::Time::now());
+  }
   point_cloud.header.frame_id =
-      (combine_sensors) ? "cepton_0"
-                        : ("cepton_" + std::to_string(serial_number));
+      (has_transform) ? parent_frame_id : sensor.frame_id;
+
+  // Compose with target frame transform, so that points are transformed once
+  if (target_frame_lookup.is_started()) {
+    cepton_sdk::util::CompiledTransform target_transform;
+    if (target_frame_lookup.lookup(point_cloud.header.frame_id,
+                                   point_cloud.header.stamp,
+                                   target_transform)) {
+      transform = (has_transform)
+                      ? compose_transforms(target_transform, transform)
+                      : target_transform;
+      has_transform = true;
+      point_cloud.header.frame_id = target_frame_lookup.target_frame;
+    } else {
+      // Drop, instead of mixing sensor and target frame points in outputs
+      NODELET_WARN_THROTTLE(5.0, "No transform from %s to %s. Dropping points.",
+                            point_cloud.header.frame_id.c_str(),
+                            target_frame_lookup.target_frame.c_str());
+      return false;
+    }
+  }
+  point_cloud.resize(n_points);
+
+  // Convert and transform image points to points, in blocks, and apply per
+  // point stages while the block is in cache. Occluded and background points
+  // are dropped.
+  StageScope convert_scope(get_stage_counters(sensor), STAGE_CONVERT);
+  auto *const points = point_cloud.points.data();
+  std::size_t n_output_points = 0;
+  const auto &occlusion_mask = sensor.occlusion_mask;
+  const bool has_occlusion_mask = !occlusion_mask.empty();
+  std::size_t n_outside_grid = 0;
+  for (std::size_t i_block = 0; i_block < n_points;
+       i_block += point_kernel_block_size) {
+    const std::size_t i_block_end =
+        std::min(i_block + point_kernel_block_size, n_points);
+    sensor.kernels->convert(transform, i_block_end - i_block,
+                            c_image_points + i_block, points + i_block);
+    for (std::size_t i = i_block; i < i_block_end; ++i) {
+      const auto &input_point = points[i];
+      if ((std::abs(input_point.image_x) >= grid_extent) ||
+          (std::abs(input_point.image_z) >= grid_extent))
+        ++n_outside_grid;
+      if (has_occlusion_mask &&
+          occlusion_mask.is_masked(input_point.image_x, input_point.image_z,
+                                   input_point.distance))
+        continue;
+      auto &point = points[n_output_points];
+      if (n_output_points != i) point = input_point;
+      if (correct_clock)
+        point.timestamp = clock_estimator.to_host(point.timestamp);
+      if (sensor.occlusion_mask.is_calibrating())
+        sensor.occlusion_mask.add_point(point);
+      if (temporal_filter) sensor.temporal_filter.add_point(point);
+      if (background_subtraction && !sensor.background_model.add_point(point))
+        continue;
+      if (publish_statistics) sensor.statistics.add(point);
+      ++n_output_points;
+    }
+  }
+  point_cloud.resize(n_output_points);
   point_cloud.height = 1;
-  point_cloud.width = points.size();
-  point_cloud.resize(points.size());
-  for (std::size_t i = 0; i < points.size(); ++i) {
-    point_cloud.points[i] = points[i];
+  point_cloud.width = n_output_points;
+  convert_scope.stop();
+
+  const bool uses_grid =
+      has_occlusion_mask || occlusion_mask.is_calibrating() ||
+      temporal_filter || background_subtraction || outlier_filter_streams ||
+      publish_delta;
+  if (uses_grid && n_outside_grid) {
+    NODELET_WARN_THROTTLE(
+        10.0, "Sensor %lu: %lu points outside of image grid (grid_extent %g).",
+        (unsigned long)sensor.serial_number, (unsigned long)n_outside_grid,
+        grid_extent);
+  }
+
+  render_depth_images(point_cloud);
+  return true;
+}
+
+void DriverNodelet::render_depth_images(const CeptonPointCloud &point_cloud) {
+  for (const auto &camera : cameras) {
+    // Transform is only valid for points in camera frame
+    if (point_cloud.header.frame_id != camera->frame_id) {
+      NODELET_WARN_THROTTLE(10.0, "Camera %s skipped points in frame %s.",
+                            camera->name.c_str(),
+                            point_cloud.header.frame_id.c_str());
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    auto &depth_image = camera->depth_image;
+    if (depth_image.empty()) continue;
+    for (const auto &point : point_cloud.points) {
+      if (point.valid) depth_image.add_point(point.x, point.y, point.z);
+    }
+  }
+}
+
+void DriverNodelet::finish_frame(SensorState &sensor) {
+  if (outlier_filter_streams) {
+    StageScope scope(get_stage_counters(sensor), STAGE_FILTER);
+    sensor.outlier_filter.radius = outlier_filter_radius;
+    sensor.outlier_filter.min_neighbors = outlier_filter_min_neighbors;
+    sensor.outlier_filter.std_ratio = outlier_filter_std_ratio;
+    sensor.outlier_filter.filter(*sensor.point_cloud,
+                                 sensor.filtered_point_cloud);
+
+    // Statistics describe `cepton/points`, so recompute without outliers
+    if (publish_statistics && (outlier_filter_streams & OUTPUT_POINTS)) {
+      sensor.statistics.clear();
+      for (const auto &point : sensor.filtered_point_cloud.points)
+        sensor.statistics.add(point);
+    }
+  }
+  if (sensor.occlusion_mask.next_frame()) {
+    NODELET_INFO("Sensor %lu occlusion mask calibrated.",
+                 (unsigned long)sensor.serial_number);
+    if (!occlusion_mask_path.empty())
+      sensor.occlusion_mask.save(get_sensor_path(
+          occlusion_mask_path, "occlusion_mask", sensor.serial_number));
+  }
+  if (temporal_filter) sensor.temporal_filter.next_frame();
+  if (background_subtraction) {
+    auto &background_model = sensor.background_model;
+    const bool was_learning = background_model.is_learning();
+    background_model.next_frame();
+    if (was_learning && !background_model.is_learning()) {
+      NODELET_INFO("Sensor %lu background learned.",
+                   (unsigned long)sensor.serial_number);
+      if (!background_path.empty())
+        background_model.save(get_sensor_path(
+            background_path, "background", sensor.serial_number));
+    }
+  }
+}
+
+void DriverNodelet::publish_progressive_layers(SensorState &sensor) {
+  if (!publish_progressive) return;
+  const auto &point_cloud =
+      get_output_point_cloud(sensor, OUTPUT_PROGRESSIVE);
+  auto &layer_point_cloud = sensor.layer_point_cloud;
+  layer_point_cloud.header = point_cloud.header;
+
+  // Layer 0 has points `i % 2^(n - 1) == 0`, and layer k > 0 has points
+  // `i % 2^(n - k) == 2^(n - k - 1)`.
+  const std::size_t n_points = point_cloud.size();
+  const auto get_layer = [this](int i_layer, std::size_t &i_start,
+                                std::size_t &stride) {
+    stride = std::size_t(1) << (progressive_layers - std::max(i_layer, 1));
+    i_start = (i_layer == 0) ? 0 : stride / 2;
+  };
+  std::size_t n_bytes = 0;
+  for (int i_layer = 0; i_layer < progressive_layers; ++i_layer) {
+    std::size_t i_start, stride;
+    get_layer(i_layer, i_start, stride);
+    StageScope serialize_scope(get_stage_counters(sensor), STAGE_SERIALIZE);
+    layer_point_cloud.clear();
+    for (std::size_t i = i_start; i < n_points; i += stride)
+      layer_point_cloud.points.push_back(point_cloud.points[i]);
+    layer_point_cloud.height = 1;
+    layer_point_cloud.width = layer_point_cloud.points.size();
+
+    ProgressiveLayer msg;
+    msg.header = pcl_conversions::fromPCL(point_cloud.header);
+    msg.serial_number = sensor.serial_number;
+    msg.frame_index = sensor.frame_index;
+    msg.layer_index = i_layer;
+    msg.n_layers = progressive_layers;
+    encode_compact_point_cloud(layer_point_cloud, compact_encoding,
+                               compact_resolution, msg.points);
+    msg.points.header = msg.header;
+    n_bytes += msg.points.data.size();
+
+    // Always publish first layer. Stop if next layer would exceed budget.
+    msg.is_last = (i_layer == progressive_layers - 1);
+    if (!msg.is_last && (progressive_max_bytes > 0)) {
+      get_layer(i_layer + 1, i_start, stride);
+      const std::size_t n_next =
+          (n_points > i_start) ? (n_points - i_start + stride - 1) / stride
+                               : 0;
+      if (n_bytes + n_next * msg.points.point_size >
+          std::size_t(progressive_max_bytes))
+        msg.is_last = true;
+    }
+    serialize_scope.stop();
+    {
+      StageScope scope(get_stage_counters(sensor), STAGE_PUBLISH);
+      progressive_publisher.publish(msg);
+    }
+    if (msg.is_last) break;
+  }
+}
+
+void DriverNodelet::publish_delta_frame(SensorState &sensor) {
+  if (!publish_delta) return;
+  auto &delta_encoder = sensor.delta_encoder;
+  delta_encoder.keyframe_interval = delta_keyframe_interval;
+  delta_encoder.max_distance = delta_max_distance;
+  delta_encoder.max_intensity = delta_max_intensity;
+
+  DeltaFrame msg;
+  msg.serial_number = sensor.serial_number;
+  {
+    StageScope scope(get_stage_counters(sensor), STAGE_SERIALIZE);
+    delta_encoder.encode(get_output_point_cloud(sensor, OUTPUT_DELTA), msg);
+  }
+  StageScope scope(get_stage_counters(sensor), STAGE_PUBLISH);
+  delta_publisher.publish(msg);
+}
+
+void DriverNodelet::cache_latest_frame(SensorState &sensor) {
+  if (!latest_frame_service) return;
+  StageScope scope(get_stage_counters(sensor), STAGE_COPY);
+  // Assignment reuses buffer capacity
+  sensor.latest_frame.get_write_buffer() =
+      get_output_point_cloud(sensor, OUTPUT_LATEST_FRAME);
+  sensor.latest_frame.publish();
+}
+
+const CeptonPointCloud &DriverNodelet::get_output_point_cloud(
+    const SensorState &sensor, OutputStream stream) const {
+  return (outlier_filter_streams & stream) ? sensor.filtered_point_cloud
+                                           : *sensor.point_cloud;
+}
+
+void DriverNodelet::publish_frame_statistics(const SensorState &sensor) {
+  if (!publish_statistics) return;
+  FrameStatistics msg;
+  msg.header = pcl_conversions::fromPCL(sensor.point_cloud->header);
+  msg.serial_number = sensor.serial_number;
+  sensor.statistics.to_message(msg);
+  statistics_publisher.publish(msg);
+}
+
+void DriverNodelet::publish_polar_points(SensorState &sensor) {
+  if (!publish_polar) return;
+  // Polar coordinates are in sensor frame, even if transforms are applied
+  const auto &point_cloud = get_output_point_cloud(sensor, OUTPUT_POLAR);
+  PolarPointCloud msg;
+  msg.header = pcl_conversions::fromPCL(point_cloud.header);
+  msg.header.frame_id = sensor.frame_id;
+  {
+    StageScope scope(get_stage_counters(sensor), STAGE_SERIALIZE);
+    encode_polar_point_cloud(point_cloud, polar_resolution, msg);
+  }
+  StageScope scope(get_stage_counters(sensor), STAGE_PUBLISH);
+  polar_points_publisher.publish(msg);
+}
+
+void DriverNodelet::publish_point_cloud(SensorState &sensor) {
+  const auto &point_cloud = get_output_point_cloud(sensor, OUTPUT_POINTS);
+  if (n_frames == 0) {
+    const double time_to_first_frame =
+        (ros::WallTime::now() - init_time).toSec();
+    NODELET_INFO("Time to first frame: %.3f s.", time_to_first_frame);
+    private_node_handle.setParam("time_to_first_frame", time_to_first_frame);
+  }
+
+  if (clock_publisher) {
+    rosgraph_msgs::Clock clock_msg;
+    clock_msg.clock = rosutil::from_usec(point_cloud.header.stamp);
+    clock_publisher.publish(clock_msg);
+  }
+
+  StageScope scope(get_stage_counters(sensor), STAGE_PUBLISH);
+  if (lockstep) {
+    {
+      std::lock_guard<std::mutex> lock(lockstep_mutex);
+      lockstep_stamp = point_cloud.header.stamp;
+      lockstep_frame_id = point_cloud.header.frame_id;
+      n_acks = 0;
+    }
+    // Publish shared copy, so that we can detect when subscribers are done
+    const auto point_cloud_ptr =
+        boost::make_shared<CeptonPointCloud>(point_cloud);
+    lockstep_cloud = point_cloud_ptr;
+    points_publisher.publish(point_cloud_ptr);
+  } else {
+    points_publisher.publish(point_cloud);
+  }
+
+  ++n_frames;
+}
+
+void DriverNodelet::publish_compact_points(SensorState &sensor) {
+  if (!compact_points_publisher) return;
+  const auto &point_cloud = get_output_point_cloud(sensor, OUTPUT_COMPACT);
+  CompactPointCloud msg;
+  msg.header = pcl_conversions::fromPCL(point_cloud.header);
+  {
+    StageScope scope(get_stage_counters(sensor), STAGE_SERIALIZE);
+    encode_compact_point_cloud(point_cloud, compact_encoding,
+                               compact_resolution, msg);
+  }
+  StageScope scope(get_stage_counters(sensor), STAGE_PUBLISH);
+  compact_points_publisher.publish(msg);
+}
+
+void DriverNodelet::send_multicast_points(SensorState &sensor) {
+  if (!multicast_sender.is_open()) return;
+  const auto &point_cloud = get_output_point_cloud(sensor, OUTPUT_POINTS);
+  auto &buffer = sensor.multicast_buffer;
+  {
+    // Serialized as sensor_msgs/PointCloud2 by pcl_ros, without an
+    // intermediate message
+    StageScope scope(get_stage_counters(sensor), STAGE_SERIALIZE);
+    buffer.resize(ros::serialization::serializationLength(point_cloud));
+    ros::serialization::OStream stream(buffer.data(), buffer.size());
+    ros::serialization::serialize(stream, point_cloud);
+  }
+  // Sent on sender thread
+  StageScope scope(get_stage_counters(sensor), STAGE_PUBLISH);
+  multicast_sender.send(buffer);
+}
+
+StageCounters *DriverNodelet::get_stage_counters(SensorState &sensor) {
+  return (perf_counters) ? &sensor.stage_counters : nullptr;
+}
+
+void DriverNodelet::publish_pipeline_counters(const SensorState &sensor) {
+  if (!perf_counters) return;
+  const char *const stage_names[N_STAGES] = {"copy", "convert", "filter",
+                                             "serialize", "publish"};
+  const auto &point_cloud = *sensor.point_cloud;
+  PipelineCounters msg;
+  msg.header = pcl_conversions::fromPCL(point_cloud.header);
+  msg.serial_number = sensor.serial_number;
+  msg.n_points = point_cloud.size();
+  const double n_points = std::max<double>(point_cloud.size(), 1.0);
+  for (int i = 0; i < N_STAGES; ++i) {
+    const auto &values = sensor.stage_counters.stages[i];
+    msg.stages.push_back(stage_names[i]);
+    msg.cycles.push_back(values.cycles);
+    msg.instructions.push_back(values.instructions);
+    msg.cache_misses.push_back(values.cache_misses);
+    msg.branch_misses.push_back(values.branch_misses);
+    msg.instructions_per_cycle.push_back(
+        (values.cycles) ? double(values.instructions) / values.cycles : 0.0);
+    msg.cache_misses_per_point.push_back(values.cache_misses / n_points);
+    msg.branch_misses_per_point.push_back(values.branch_misses / n_points);
   }
-  points_publisher.publish(point_cloud);
+  pipeline_counters_publisher.publish(msg);
 }
 
 }  // namespace cepton_ros
@@ -1,16 +1,47 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 
 #include <nodelet/nodelet.h>
+#include <pcl_conversions/pcl_conversions.h>
 #include <pcl_ros/point_cloud.h>
 #include <ros/ros.h>
+#include <rosgraph_msgs/Clock.h>
+#include <sensor_msgs/CameraInfo.h>
 #include <sensor_msgs/PointCloud2.h>
+#include <std_msgs/Header.h>
+#include <std_srvs/Trigger.h>
 #include <cepton_sdk_api.hpp>
 
+#include "cepton_ros/CompactPointCloud.h"
+#include "cepton_ros/DeltaFrame.h"
+#include "cepton_ros/FrameStatistics.h"
+#include "cepton_ros/GetLatestFrame.h"
+#include "cepton_ros/PipelineCounters.h"
+#include "cepton_ros/PointCloudChunk.h"
+#include "cepton_ros/PolarPointCloud.h"
+#include "cepton_ros/ProgressiveLayer.h"
+#include "cepton_ros/SeekReplay.h"
 #include "cepton_ros/SensorInformation.h"
+#include "cepton_ros/SetReplayRate.h"
+#include "cepton_ros/StepReplay.h"
 #include "cepton_ros/common.hpp"
 #include "cepton_ros/point.hpp"
+#include "cepton_ros/polar_point_cloud.hpp"
+#include "camera_depth.hpp"
+#include "capture_replay.hpp"
+#include "compact_encoder.hpp"
+#include "multicast_transport.hpp"
+#include "perf_counters.hpp"
+#include "sensor_state.hpp"
+#include "target_frame_lookup.hpp"
+#include "transforms_watcher.hpp"
 
 namespace cepton_ros {
 
@@ -20,6 +51,16 @@ namespace cepton_ros {
  */
 class DriverNodelet : public nodelet::Nodelet {
  public:
+  /// Output stream flags, for per stream options.
+  enum OutputStream : uint32_t {
+    OUTPUT_POINTS = 1 << 0,
+    OUTPUT_COMPACT = 1 << 1,
+    OUTPUT_POLAR = 1 << 2,
+    OUTPUT_PROGRESSIVE = 1 << 3,
+    OUTPUT_DELTA = 1 << 4,
+    OUTPUT_LATEST_FRAME = 1 << 5,
+  };
+
   ~DriverNodelet();
 
   void on_image_points(cepton_sdk::SensorHandle sensor_handle,
@@ -30,25 +71,204 @@ class DriverNodelet : public nodelet::Nodelet {
   void onInit() override;
 
  private:
+  struct Camera {
+    std::string name;
+    /// Points frame of camera transform.
+    std::string frame_id;
+    std::mutex mutex;
+    DepthImage depth_image;
+    ros::Subscriber camera_info_subscriber;
+    ros::Publisher depth_publisher;
+  };
+
+  /// Loads cameras, and subscribes to camera info. Cameras without frame use
+  /// `points_frame_id`. If it is empty, they are skipped.
+  void init_cameras(const std::string &path,
+                    const std::string &points_frame_id);
+  /// Publishes depth image rendered since previous camera frame.
+  void on_camera_info(Camera &camera,
+                      const sensor_msgs::CameraInfo::ConstPtr &msg);
+
+  /// Opens capture and starts replay. Runs in capture thread.
+  void start_capture(const std::vector<std::string> &paths, bool loop);
+  void on_ack(const std_msgs::Header::ConstPtr &msg);
+  /// Replays one frame at a time, waiting for consumers after each frame.
+  void run_lockstep();
+
+  bool on_pause_replay(std_srvs::Trigger::Request &request,
+                       std_srvs::Trigger::Response &response);
+  bool on_resume_replay(std_srvs::Trigger::Request &request,
+                        std_srvs::Trigger::Response &response);
+  bool on_seek_replay(SeekReplay::Request &request,
+                      SeekReplay::Response &response);
+  /// Pauses replay, and replays until `n_frames` frames are published.
+  bool on_step_replay(StepReplay::Request &request,
+                      StepReplay::Response &response);
+  bool on_set_replay_rate(SetReplayRate::Request &request,
+                          SetReplayRate::Response &response);
+
+  /// Returns copy of latest frame.
+  bool on_get_latest_frame(GetLatestFrame::Request &request,
+                           GetLatestFrame::Response &response);
+
   void publish_sensor_information(
       const cepton_sdk::SensorInformation &sensor_info);
-  void publish_points(uint64_t serial_number);
+  /// Finds or creates sensor state, reattaching sensor if it timed out.
+  std::shared_ptr<SensorState> attach_sensor(
+      const cepton_sdk::SensorInformation &sensor_info);
+  /// Marks timed out sensors dead, and releases their buffers.
+  void on_liveness_timer(const ros::WallTimerEvent &event);
+
+  void publish_points(SensorState &sensor, std::size_t n_points,
+                      const cepton_sdk::SensorImagePoint *const c_image_points);
+  /// Adds streamed points, and publishes chunks and completed frames.
+  void add_chunk_points(
+      SensorState &sensor, const cepton_sdk::SensorInformation &sensor_info,
+      std::size_t n_points,
+      const cepton_sdk::SensorImagePoint *const c_image_points);
+  /// Publishes `sensor.image_points[i_start:i_end]` as chunk, and appends it
+  /// to frame. Returns false if frame is dropped.
+  bool publish_chunk(SensorState &sensor, std::size_t i_start,
+                     std::size_t i_end, bool is_last);
+  /// Filters completed frame, and publishes it on all outputs.
+  void publish_frame(SensorState &sensor);
+  /// Samples sensor clock. Called once per frame.
+  void update_clock(SensorState &sensor, std::size_t n_points,
+                    const cepton_sdk::SensorImagePoint *const c_image_points);
+  /// Converts image points to points, and sets header. Adds points to frame
+  /// statistics. Drops occluded and background points. Returns false if
+  /// points must be dropped, because the target frame transform is not
+  /// available.
+  bool convert_points(SensorState &sensor, std::size_t n_points,
+                      const cepton_sdk::SensorImagePoint *const c_image_points,
+                      CeptonPointCloud &point_cloud);
+  /// Renders points into camera depth images.
+  void render_depth_images(const CeptonPointCloud &point_cloud);
+  /// Updates per frame filter state, and filters outliers.
+  void finish_frame(SensorState &sensor);
+  /// Returns frame for output stream.
+  const CeptonPointCloud &get_output_point_cloud(const SensorState &sensor,
+                                                 OutputStream stream) const;
+  void publish_point_cloud(SensorState &sensor);
+  void publish_compact_points(SensorState &sensor);
+  /// Serializes frame once, and sends it to multicast group.
+  void send_multicast_points(SensorState &sensor);
+  /// Publishes sensor frame in polar encoding.
+  void publish_polar_points(SensorState &sensor);
+  /// Publishes frame as refinement layers, until link budget is exhausted.
+  void publish_progressive_layers(SensorState &sensor);
+  /// Publishes changes since previous delta frame.
+  void publish_delta_frame(SensorState &sensor);
+  void publish_frame_statistics(const SensorState &sensor);
+  /// Copies frame to latest frame buffer.
+  void cache_latest_frame(SensorState &sensor);
+  /// Returns null if performance counters are disabled.
+  StageCounters *get_stage_counters(SensorState &sensor);
+  void publish_pipeline_counters(const SensorState &sensor);
 
  private:
   ros::NodeHandle node_handle;
   ros::NodeHandle private_node_handle;
+  ros::WallTime init_time;
 
   bool combine_sensors = false;
+  float sensor_timeout = 1.0f;  ///< [seconds]
+  std::string parent_frame_id = "cepton";
+  bool clock_correction = false;
+
+  /// Filter and delta frame grids cover [-grid_extent, grid_extent] image
+  /// coordinates. Points outside are not filtered.
+  float grid_extent = 1.0f;
+
+  std::string occlusion_mask_path;  ///< Occlusion masks directory.
+  bool occlusion_mask_calibrate = false;
+  float occlusion_mask_max_distance = 3.0f;  ///< [meters]
+
+  bool temporal_filter = false;
+  float temporal_filter_max_distance = 10.0f;  ///< [meters]
+  float temporal_filter_max_intensity = 0.1f;
+
+  bool background_subtraction = false;
+  std::string background_path;  ///< Background models directory.
+  int background_learning_frames = 100;
+
+  uint32_t outlier_filter_streams = 0;  ///< `OutputStream` flags.
+  int outlier_filter_radius = 1;  ///< Window radius [cells].
+  int outlier_filter_min_neighbors = 2;
+  float outlier_filter_std_ratio = 2.0f;
+
+  uint8_t compact_encoding = CompactPointCloud::ENCODING_FLOAT16;
+  float compact_resolution = 0.01f;  ///< [meters]
+
+  bool publish_polar = false;
+  float polar_resolution = 0.005f;  ///< [meters]
+
+  bool publish_progressive = false;
+  int progressive_layers = 5;     ///< Layer 0 has every 2^(n - 1)th point.
+  int progressive_max_bytes = 0;  ///< Per frame link budget (0: unlimited).
+
+  bool publish_delta = false;
+  int delta_keyframe_interval = 10;
+  float delta_max_distance = 0.05f;  ///< [meters]
+  float delta_max_intensity = 0.1f;
+
+  std::string multicast_group;  ///< If empty, multicast is disabled.
+
+  bool publish_statistics = true;
+  bool perf_counters = false;
+  bool latest_frame_service = false;
+  bool publish_chunks = false;
+  int chunk_size = 1000;  ///< Minimum points per chunk.
+  cepton_sdk::FrameOptions frame_options;
+
+  bool lockstep = false;
+  int lockstep_consumers = 0;
+  float lockstep_timeout = 0.0f;
 
   cepton_sdk::api::SensorErrorCallback error_callback;
   cepton_sdk::api::SensorImageFrameCallback image_frame_callback;
+  CaptureReplay capture_replay;
+  TransformsWatcher transforms_watcher;
+  TargetFrameLookup target_frame_lookup;
+  MulticastSender multicast_sender;
+  std::atomic<uint64_t> n_frames{0};
+
+  std::thread capture_thread;
+  std::atomic<bool> capture_running{false};
+  std::mutex lockstep_mutex;
+  std::condition_variable lockstep_condition_variable;
+  int64_t lockstep_stamp = 0;
+  std::string lockstep_frame_id;
+  int n_acks = 0;
+  boost::weak_ptr<const CeptonPointCloud> lockstep_cloud;
 
-  ros::Timer timer;
+  ros::WallTimer liveness_timer;
   ros::Publisher sensor_info_publisher;
   ros::Publisher points_publisher;
+  ros::Publisher chunks_publisher;
+  ros::Publisher compact_points_publisher;
+  ros::Publisher polar_points_publisher;
+  ros::Publisher progressive_publisher;
+  ros::Publisher delta_publisher;
+  ros::Publisher statistics_publisher;
+  ros::Publisher pipeline_counters_publisher;
+  ros::Publisher clock_publisher;
+  ros::Subscriber ack_subscriber;
+
+  ros::ServiceServer pause_replay_service;
+  ros::ServiceServer resume_replay_service;
+  ros::ServiceServer seek_replay_service;
+  ros::ServiceServer step_replay_service;
+  ros::ServiceServer set_replay_rate_service;
+  ros::ServiceServer get_latest_frame_service;
+  /// Held by latest frame readers (there is one reader per triple buffer).
+  std::mutex latest_frame_mutex;
+
+  std::vector<std::unique_ptr<Camera>> cameras;
 
-  std::vector<cepton_sdk::SensorImagePoint> image_points;
-  std::vector<cepton_sdk::util::SensorPoint> points;
-  CeptonPointCloud point_cloud;
+  std::mutex sensors_mutex;
+  std::unordered_map<uint64_t, std::shared_ptr<SensorState>> sensors;
+  std::shared_ptr<PointCloudPool> point_cloud_pool =
+      std::make_shared<PointCloudPool>();
 };
 }  // namespace cepton_ros
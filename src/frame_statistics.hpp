@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include <cepton_sdk_util.hpp>
+
+#include "cepton_ros/FrameStatistics.h"
+
+namespace cepton_ros {
+
+/// Accumulates frame statistics in the point conversion loop.
+class FrameStatisticsAccumulator {
+ public:
+  FrameStatisticsAccumulator() { clear(); }
+
+  void clear() {
+    n_points = 0;
+    n_valid = 0;
+    n_saturated = 0;
+    sum_distance = 0.0;
+    min_distance = std::numeric_limits<float>::max();
+    max_distance = std::numeric_limits<float>::lowest();
+    min_position.fill(std::numeric_limits<float>::max());
+    max_position.fill(std::numeric_limits<float>::lowest());
+    min_timestamp = std::numeric_limits<int64_t>::max();
+    max_timestamp = std::numeric_limits<int64_t>::min();
+    intensity_histogram.fill(0);
+  }
+
+  void add(const cepton_sdk::util::SensorPoint &point) {
+    ++n_points;
+    min_timestamp = std::min(min_timestamp, point.timestamp);
+    max_timestamp = std::max(max_timestamp, point.timestamp);
+    if (!point.valid) return;
+
+    ++n_valid;
+    sum_distance += point.distance;
+    min_distance = std::min(min_distance, point.distance);
+    max_distance = std::max(max_distance, point.distance);
+    const float position[3] = {point.x, point.y, point.z};
+    for (int i = 0; i < 3; ++i) {
+      min_position[i] = std::min(min_position[i], position[i]);
+      max_position[i] = std::max(max_position[i], position[i]);
+    }
+    if (point.saturated) {
+      ++n_saturated;
+      return;
+    }
+    const int i_bin = std::max(
+        std::min(int(point.intensity * n_intensity_bins), n_intensity_bins - 1),
+        0);
+    ++intensity_histogram[i_bin];
+  }
+
+  void to_message(FrameStatistics &msg) const {
+    msg.n_points = n_points;
+    msg.n_valid = n_valid;
+    msg.n_invalid = n_points - n_valid;
+    msg.n_saturated = n_saturated;
+    if (n_valid > 0) {
+      msg.min_distance = min_distance;
+      msg.max_distance = max_distance;
+      msg.mean_distance = float(sum_distance / n_valid);
+      std::copy(min_position.begin(), min_position.end(),
+                msg.min_position.begin());
+      std::copy(max_position.begin(), max_position.end(),
+                msg.max_position.begin());
+    }
+    if (n_points > 0) {
+      msg.min_timestamp = min_timestamp;
+      msg.max_timestamp = max_timestamp;
+    }
+    std::copy(intensity_histogram.begin(), intensity_histogram.end(),
+              msg.intensity_histogram.begin());
+  }
+
+ public:
+  static constexpr int n_intensity_bins = 10;
+
+  uint32_t n_points;
+  uint32_t n_valid;
+  uint32_t n_saturated;
+  double sum_distance;
+  float min_distance;
+  float max_distance;
+  std::array<float, 3> min_position;
+  std::array<float, 3> max_position;
+  int64_t min_timestamp;
+  int64_t max_timestamp;
+  std::array<uint32_t, n_intensity_bins> intensity_histogram;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,70 @@
+#include "grid_file.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include <ros/ros.h>
+
+namespace cepton_ros {
+
+namespace {
+struct FileHeader {
+  std::array<char, 4> magic;
+  int32_t width;
+  int32_t height;
+  float resolution;
+  float extent;
+  int64_t value;
+};
+}  // namespace
+
+bool GridFile::load(const std::string &path, const ImageGrid &grid,
+                    void *data, std::size_t n_bytes, int64_t &value) const {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return false;
+  FileHeader header;
+  file.read((char *)&header, sizeof(header));
+  if (file && (header.magic == magic) && (header.width == grid.width) &&
+      (header.height == grid.height) &&
+      (header.resolution == grid.resolution) &&
+      (header.extent == grid.extent)) {
+    file.read((char *)data, n_bytes);
+  } else {
+    file.setstate(std::ios::failbit);
+  }
+  if (!file) {
+    ROS_WARN("Invalid %s %s.", name.c_str(), path.c_str());
+    return false;
+  }
+  value = header.value;
+  return true;
+}
+
+bool GridFile::save(const std::string &path, const ImageGrid &grid,
+                    const void *data, std::size_t n_bytes,
+                    int64_t value) const {
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    FileHeader header = {};
+    header.magic = magic;
+    header.width = grid.width;
+    header.height = grid.height;
+    header.resolution = grid.resolution;
+    header.extent = grid.extent;
+    header.value = value;
+    file.write((const char *)&header, sizeof(header));
+    file.write((const char *)data, n_bytes);
+    if (!file) {
+      ROS_WARN("Failed to save %s %s.", name.c_str(), path.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    ROS_WARN("Failed to save %s %s.", name.c_str(), path.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "cepton_ros/image_grid.hpp"
+
+namespace cepton_ros {
+
+/// Per sensor image grid file (occlusion masks, background models).
+/**
+ * Files have a header with the file type magic, the grid, and one type
+ * specific value, followed by the cell data. Files are written to a
+ * temporary file and renamed, so that they are never partial.
+ */
+struct GridFile {
+  std::array<char, 4> magic;  ///< Type and version.
+  std::string name;           ///< For messages.
+
+  /// Reads `n_bytes` of cell data. Fails if type or grid does not match.
+  bool load(const std::string &path, const ImageGrid &grid, void *data,
+            std::size_t n_bytes, int64_t &value) const;
+  bool save(const std::string &path, const ImageGrid &grid,
+            const void *data, std::size_t n_bytes, int64_t value) const;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,416 @@
+#include "multi_capture_replay.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+namespace cepton_ros {
+
+namespace {
+const uint32_t pcap_magic_usec = 0xa1b2c3d4;
+const uint32_t pcap_magic_nsec = 0xa1b23c4d;
+const std::size_t pcap_header_size = 24;
+const std::size_t pcap_record_header_size = 16;
+
+const uint32_t linktype_ethernet = 1;
+const uint32_t linktype_raw = 101;
+const uint32_t linktype_linux_sll = 113;
+
+inline uint16_t read_be16(const uint8_t *const data) {
+  return (uint16_t(data[0]) << 8) | uint16_t(data[1]);
+}
+
+inline uint32_t read_be32(const uint8_t *const data) {
+  return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) |
+         (uint32_t(data[2]) << 8) | uint32_t(data[3]);
+}
+
+inline uint32_t read_u32(const uint8_t *const data, bool swap) {
+  uint32_t value;
+  std::copy(data, data + 4, (uint8_t *)&value);
+  return (swap) ? __builtin_bswap32(value) : value;
+}
+
+inline int64_t get_wall_time_usec() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+cepton_sdk::SensorError create_error(cepton_sdk::SensorErrorCode error_code,
+                                     const std::string &msg) {
+  return cepton_sdk::SensorError(error_code, msg.c_str());
+}
+}  // namespace
+
+MultiCaptureReplay::~MultiCaptureReplay() { close(); }
+
+bool MultiCaptureReplay::is_open() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return !m_captures.empty();
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::open(
+    const std::vector<std::string> &paths) {
+  auto error = close();
+  if (error) return error;
+  if (paths.empty()) return CEPTON_ERROR_INVALID_ARGUMENTS;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_captures.resize(paths.size());
+  m_start_time = INT64_MAX;
+  m_end_time = INT64_MIN;
+  for (std::size_t i = 0; i < paths.size(); ++i) {
+    auto &capture = m_captures[i];
+    error = open_capture(paths[i], capture);
+    if (error) {
+      close_impl();
+      return error;
+    }
+    if (capture.packets.empty()) continue;
+    m_start_time = std::min(m_start_time, capture.packets.front().timestamp);
+    m_end_time = std::max(m_end_time, capture.packets.back().timestamp);
+  }
+  if (m_start_time > m_end_time) {
+    close_impl();
+    return create_error(CEPTON_ERROR_CORRUPT_FILE, "No sensor packets found");
+  }
+  seek_impl(m_start_time);
+  return CEPTON_SUCCESS;
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::open_capture(
+    const std::string &path, Capture &capture) {
+  capture.path = path;
+
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return create_error(CEPTON_ERROR_FILE_IO, "Failed to open " + path);
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) < 0) {
+    ::close(fd);
+    return create_error(CEPTON_ERROR_FILE_IO, "Failed to stat " + path);
+  }
+  capture.size = file_stat.st_size;
+  if (capture.size < pcap_header_size) {
+    ::close(fd);
+    return create_error(CEPTON_ERROR_INVALID_FILE_TYPE, path);
+  }
+  void *const data = mmap(nullptr, capture.size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    capture.size = 0;
+    return create_error(CEPTON_ERROR_FILE_IO, "Failed to mmap " + path);
+  }
+  capture.data = (const uint8_t *)data;
+
+  // Global header
+  const uint32_t magic = read_u32(capture.data, false);
+  bool swap;
+  bool is_nsec;
+  if ((magic == pcap_magic_usec) || (magic == pcap_magic_nsec)) {
+    swap = false;
+    is_nsec = (magic == pcap_magic_nsec);
+  } else if ((__builtin_bswap32(magic) == pcap_magic_usec) ||
+             (__builtin_bswap32(magic) == pcap_magic_nsec)) {
+    swap = true;
+    is_nsec = (__builtin_bswap32(magic) == pcap_magic_nsec);
+  } else {
+    return create_error(CEPTON_ERROR_INVALID_FILE_TYPE, path);
+  }
+  const uint32_t linktype = read_u32(capture.data + 20, swap);
+  std::size_t link_header_size;
+  switch (linktype) {
+    case linktype_ethernet:
+      link_header_size = 14;
+      break;
+    case linktype_raw:
+      link_header_size = 0;
+      break;
+    case linktype_linux_sll:
+      link_header_size = 16;
+      break;
+    default:
+      return create_error(CEPTON_ERROR_INVALID_FILE_TYPE,
+                          "Unsupported link type in " + path);
+  }
+  const uint16_t port = (cepton_sdk::is_initialized())
+                            ? cepton_sdk::get_port()
+                            : uint16_t(8808);
+
+  // Index UDP packets
+  std::size_t offset = pcap_header_size;
+  while (offset + pcap_record_header_size <= capture.size) {
+    const uint8_t *const record = capture.data + offset;
+    const uint32_t ts_sec = read_u32(record, swap);
+    const uint32_t ts_frac = read_u32(record + 4, swap);
+    const uint32_t captured_size = read_u32(record + 8, swap);
+    offset += pcap_record_header_size;
+    if (offset + captured_size > capture.size) break;
+    const uint8_t *frame = capture.data + offset;
+    std::size_t frame_size = captured_size;
+    offset += captured_size;
+
+    // Link layer
+    if (frame_size < link_header_size) continue;
+    if (linktype == linktype_ethernet) {
+      uint16_t ether_type = read_be16(frame + 12);
+      if (ether_type == 0x8100) {
+        if (frame_size < link_header_size + 4) continue;
+        ether_type = read_be16(frame + 16);
+        frame += 4;
+        frame_size -= 4;
+      }
+      if (ether_type != 0x0800) continue;
+    } else if (linktype == linktype_linux_sll) {
+      if (read_be16(frame + 14) != 0x0800) continue;
+    }
+    frame += link_header_size;
+    frame_size -= link_header_size;
+
+    // IPv4
+    if (frame_size < 20) continue;
+    if ((frame[0] >> 4) != 4) continue;
+    const std::size_t ip_header_size = 4 * (frame[0] & 0x0f);
+    if (frame[9] != 17) continue;
+    if (read_be16(frame + 6) & 0x3fff) continue;  // Fragmented
+    if (frame_size < ip_header_size + 8) continue;
+    const uint32_t source_ip = read_be32(frame + 12);
+
+    // UDP
+    const uint8_t *const udp = frame + ip_header_size;
+    if (read_be16(udp + 2) != port) continue;
+    if (read_be16(udp + 4) < 8) continue;
+    const std::size_t payload_size =
+        std::min<std::size_t>(read_be16(udp + 4), frame_size - ip_header_size) -
+        8;
+
+    Packet packet;
+    packet.timestamp = int64_t(ts_sec) * int64_t(1000000) +
+                       ((is_nsec) ? int64_t(ts_frac / 1000) : int64_t(ts_frac));
+    packet.handle = cepton_sdk::SensorHandle(source_ip) |
+                    cepton_sdk::SENSOR_HANDLE_FLAG_MOCK;
+    packet.data = udp + 8;
+    packet.size = payload_size;
+    capture.packets.push_back(packet);
+  }
+  std::stable_sort(capture.packets.begin(), capture.packets.end(),
+                   [](const Packet &a, const Packet &b) {
+                     return a.timestamp < b.timestamp;
+                   });
+  madvise((void *)capture.data, capture.size, MADV_SEQUENTIAL);
+  return CEPTON_SUCCESS;
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::close() {
+  pause();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  close_impl();
+  return CEPTON_SUCCESS;
+}
+
+void MultiCaptureReplay::close_impl() {
+  for (auto &capture : m_captures) {
+    if (capture.data) munmap((void *)capture.data, capture.size);
+  }
+  m_captures.clear();
+  m_heap.clear();
+  m_start_time = 0;
+  m_end_time = 0;
+  m_time = 0;
+}
+
+int64_t MultiCaptureReplay::get_start_time() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_start_time;
+}
+
+float MultiCaptureReplay::get_position() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return 1e-6f * float(m_time - m_start_time);
+}
+
+int64_t MultiCaptureReplay::get_time() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_time;
+}
+
+float MultiCaptureReplay::get_length() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return 1e-6f * float(m_end_time - m_start_time);
+}
+
+bool MultiCaptureReplay::is_end() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_heap.empty();
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::seek(float position) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_captures.empty()) return CEPTON_ERROR_NOT_OPEN;
+  if ((position < 0.0f) || (position > 1e-6f * (m_end_time - m_start_time)))
+    return CEPTON_ERROR_INVALID_ARGUMENTS;
+  seek_impl(m_start_time + int64_t(1e6 * double(position)));
+  m_condition_variable.notify_all();
+  return CEPTON_SUCCESS;
+}
+
+void MultiCaptureReplay::seek_impl(int64_t timestamp) {
+  m_heap.clear();
+  for (std::size_t i = 0; i < m_captures.size(); ++i) {
+    auto &capture = m_captures[i];
+    capture.i_packet =
+        std::lower_bound(capture.packets.begin(), capture.packets.end(),
+                         timestamp,
+                         [](const Packet &packet, int64_t t) {
+                           return packet.timestamp < t;
+                         }) -
+        capture.packets.begin();
+    if (capture.i_packet >= capture.packets.size()) continue;
+    m_heap.emplace_back(capture.packets[capture.i_packet].timestamp, i);
+  }
+  std::make_heap(m_heap.begin(), m_heap.end(),
+                 std::greater<std::pair<int64_t, std::size_t>>());
+  m_time = timestamp;
+  m_reference_time = m_time;
+  m_reference_wall_time = get_wall_time_usec();
+}
+
+bool MultiCaptureReplay::next_packet_impl(Packet &packet) {
+  if (m_heap.empty()) {
+    if (!m_enable_loop || m_captures.empty()) return false;
+    seek_impl(m_start_time);
+    if (m_heap.empty()) return false;
+  }
+  std::pop_heap(m_heap.begin(), m_heap.end(),
+                std::greater<std::pair<int64_t, std::size_t>>());
+  auto &capture = m_captures[m_heap.back().second];
+  m_heap.pop_back();
+  packet = capture.packets[capture.i_packet];
+  ++capture.i_packet;
+  if (capture.i_packet < capture.packets.size()) {
+    m_heap.emplace_back(capture.packets[capture.i_packet].timestamp,
+                        &capture - m_captures.data());
+    std::push_heap(m_heap.begin(), m_heap.end(),
+                   std::greater<std::pair<int64_t, std::size_t>>());
+  }
+  m_time = packet.timestamp;
+  return true;
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::replay_packet(
+    const Packet &packet) {
+  return cepton_sdk::mock_network_receive(packet.handle, packet.timestamp,
+                                          packet.data, packet.size);
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::set_enable_loop(bool value) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_enable_loop = value;
+  return CEPTON_SUCCESS;
+}
+
+bool MultiCaptureReplay::get_enable_loop() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_enable_loop;
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::set_speed(float speed) {
+  if (speed < 0.0f) return CEPTON_ERROR_INVALID_ARGUMENTS;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_speed = speed;
+  m_reference_time = m_time;
+  m_reference_wall_time = get_wall_time_usec();
+  m_condition_variable.notify_all();
+  return CEPTON_SUCCESS;
+}
+
+float MultiCaptureReplay::get_speed() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_speed;
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::resume_blocking_once() {
+  auto error = pause();
+  if (error) return error;
+  Packet packet;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_captures.empty()) return CEPTON_ERROR_NOT_OPEN;
+    if (!next_packet_impl(packet)) return CEPTON_ERROR_EOF;
+  }
+  return replay_packet(packet);
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::resume_blocking(float duration) {
+  auto error = pause();
+  if (error) return error;
+  const int64_t end_time = get_time() + int64_t(1e6 * double(duration));
+  while (get_time() < end_time) {
+    error = resume_blocking_once();
+    if (error) return error;
+  }
+  return CEPTON_SUCCESS;
+}
+
+bool MultiCaptureReplay::is_running() const { return m_is_running; }
+
+cepton_sdk::SensorError MultiCaptureReplay::resume() {
+  if (m_is_running) return CEPTON_SUCCESS;
+  if (m_thread.joinable()) m_thread.join();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_captures.empty()) return CEPTON_ERROR_NOT_OPEN;
+    m_reference_time = m_time;
+    m_reference_wall_time = get_wall_time_usec();
+    m_is_running = true;
+  }
+  m_thread = std::thread([this]() { run(); });
+  return CEPTON_SUCCESS;
+}
+
+cepton_sdk::SensorError MultiCaptureReplay::pause() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_running = false;
+  }
+  m_condition_variable.notify_all();
+  if (m_thread.joinable() && (m_thread.get_id() != std::this_thread::get_id()))
+    m_thread.join();
+  return CEPTON_SUCCESS;
+}
+
+void MultiCaptureReplay::run() {
+  while (m_is_running) {
+    Packet packet;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (m_heap.empty() && !m_enable_loop) {
+        m_is_running = false;
+        break;
+      }
+
+      // Wait until packet is due, restarting if seek or speed changes
+      if (!m_heap.empty() && (m_speed > 0.0f)) {
+        const int64_t wall_time =
+            m_reference_wall_time +
+            int64_t(double(m_heap.front().first - m_reference_time) / m_speed);
+        const auto t_wait =
+            std::chrono::microseconds(wall_time - get_wall_time_usec());
+        if (t_wait.count() > 0) {
+          m_condition_variable.wait_for(lock, t_wait);
+          continue;
+        }
+      }
+      if (!next_packet_impl(packet)) continue;
+    }
+    replay_packet(packet);
+  }
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cepton_sdk.hpp>
+
+namespace cepton_ros {
+
+/// Replays several PCAP captures as one merged, time ordered packet stream.
+/**
+ * The SDK can only have one capture replay open, so each capture is mmapped
+ * and indexed here, and packets are k-way merged by timestamp and passed to
+ * `cepton_sdk::mock_network_receive`. Requires
+ * `CEPTON_SDK_CONTROL_DISABLE_NETWORK`.
+ *
+ * Mirrors the `cepton_sdk::capture_replay` interface. Position is relative to
+ * the earliest packet across all captures.
+ */
+class MultiCaptureReplay {
+ public:
+  ~MultiCaptureReplay();
+
+  bool is_open() const;
+  cepton_sdk::SensorError open(const std::vector<std::string> &paths);
+  cepton_sdk::SensorError close();
+
+  /// Capture start time [microseconds].
+  int64_t get_start_time() const;
+  /// Capture position [seconds].
+  float get_position() const;
+  /// Capture time [microseconds].
+  int64_t get_time() const;
+  /// Capture length [seconds].
+  float get_length() const;
+  bool is_end() const;
+  cepton_sdk::SensorError seek(float position);
+
+  cepton_sdk::SensorError set_enable_loop(bool value);
+  bool get_enable_loop() const;
+
+  /// Replay speed multiplier. If `speed == 0`, replays as fast as possible.
+  cepton_sdk::SensorError set_speed(float speed);
+  float get_speed() const;
+
+  /// Replays next packet synchronously.
+  cepton_sdk::SensorError resume_blocking_once();
+  /// Replays packets synchronously (not realtime) for capture duration.
+  cepton_sdk::SensorError resume_blocking(float duration);
+  bool is_running() const;
+  /// Starts realtime replay in background thread.
+  cepton_sdk::SensorError resume();
+  cepton_sdk::SensorError pause();
+
+ private:
+  struct Packet {
+    int64_t timestamp;  ///< [microseconds]
+    cepton_sdk::SensorHandle handle;
+    const uint8_t *data;
+    uint32_t size;
+  };
+
+  struct Capture {
+    std::string path;
+    const uint8_t *data = nullptr;
+    std::size_t size = 0;
+    std::vector<Packet> packets;
+    std::size_t i_packet = 0;
+  };
+
+  cepton_sdk::SensorError open_capture(const std::string &path,
+                                       Capture &capture);
+  void close_impl();
+  void seek_impl(int64_t timestamp);
+  bool next_packet_impl(Packet &packet);
+  cepton_sdk::SensorError replay_packet(const Packet &packet);
+  void run();
+
+ private:
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition_variable;
+  std::thread m_thread;
+  std::atomic<bool> m_is_running{false};
+
+  std::vector<Capture> m_captures;
+  /// Merge heap of (timestamp, capture index).
+  std::vector<std::pair<int64_t, std::size_t>> m_heap;
+  int64_t m_start_time = 0;
+  int64_t m_end_time = 0;
+  int64_t m_time = 0;
+  bool m_enable_loop = false;
+  float m_speed = 1.0f;
+
+  /// Realtime reference, reset on resume, seek, and speed change.
+  int64_t m_reference_time = 0;
+  int64_t m_reference_wall_time = 0;
+};
+
+}  // namespace cepton_ros
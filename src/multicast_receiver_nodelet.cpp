@@ -0,0 +1,65 @@
+#include "multicast_receiver_nodelet.hpp"
+
+#include <vector>
+
+#include <pluginlib/class_list_macros.h>
+
+PLUGINLIB_EXPORT_CLASS(cepton_ros::MulticastReceiverNodelet, nodelet::Nodelet);
+
+namespace cepton_ros {
+
+MulticastReceiverNodelet::~MulticastReceiverNodelet() {
+  is_running = false;
+  if (receive_thread.joinable()) receive_thread.join();
+}
+
+void MulticastReceiverNodelet::onInit() {
+  this->node_handle = getNodeHandle();
+  this->private_node_handle = getPrivateNodeHandle();
+
+  std::string multicast_group = "239.255.0.1";
+  private_node_handle.param("multicast_group", multicast_group,
+                            multicast_group);
+  int multicast_port = 7510;
+  private_node_handle.param("multicast_port", multicast_port, multicast_port);
+  std::string multicast_interface = "";
+  private_node_handle.param("multicast_interface", multicast_interface,
+                            multicast_interface);
+
+  points_publisher =
+      node_handle.advertise<sensor_msgs::PointCloud2>("cepton/points", 2);
+
+  if (!receiver.open(multicast_group, multicast_port, multicast_interface)) {
+    NODELET_FATAL("Failed to join multicast group %s:%d.",
+                  multicast_group.c_str(), multicast_port);
+    return;
+  }
+  is_running = true;
+  receive_thread = std::thread([this]() { run(); });
+}
+
+void MulticastReceiverNodelet::run() {
+  std::vector<uint8_t> frame;
+  uint64_t n_dropped = 0;
+  while (is_running) {
+    if (!receiver.receive(100, frame)) continue;
+
+    const auto msg = boost::make_shared<sensor_msgs::PointCloud2>();
+    try {
+      ros::serialization::IStream stream(frame.data(), frame.size());
+      ros::serialization::deserialize(stream, *msg);
+    } catch (const std::exception &e) {
+      NODELET_WARN("Invalid multicast frame: %s", e.what());
+      continue;
+    }
+    points_publisher.publish(msg);
+
+    if (receiver.get_n_dropped() != n_dropped) {
+      n_dropped = receiver.get_n_dropped();
+      NODELET_WARN_THROTTLE(5.0, "Dropped %lu incomplete multicast frames.",
+                            (unsigned long)n_dropped);
+    }
+  }
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <nodelet/nodelet.h>
+#include <ros/ros.h>
+#include <sensor_msgs/PointCloud2.h>
+
+#include "multicast_transport.hpp"
+
+namespace cepton_ros {
+
+/// Receives points from driver multicast transport, and republishes them.
+/**
+ * Frames with lost datagrams are dropped.
+ */
+class MulticastReceiverNodelet : public nodelet::Nodelet {
+ public:
+  ~MulticastReceiverNodelet();
+
+ protected:
+  void onInit() override;
+
+ private:
+  /// Receives frames. Runs in receive thread.
+  void run();
+
+ private:
+  ros::NodeHandle node_handle;
+  ros::NodeHandle private_node_handle;
+
+  ros::Publisher points_publisher;
+
+  MulticastReceiver receiver;
+  std::thread receive_thread;
+  std::atomic<bool> is_running{false};
+};
+}  // namespace cepton_ros
@@ -0,0 +1,314 @@
+#include "multicast_transport.hpp"
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <ros/ros.h>
+
+namespace cepton_ros {
+
+namespace {
+const std::array<char, 4> fragment_magic = {'C', 'M', 'C', '1'};
+const int ip_udp_header_size = 20 + 8;
+
+bool parse_address(const std::string &str, struct in_addr &address) {
+  return inet_pton(AF_INET, str.c_str(), &address) == 1;
+}
+
+/// Returns true if `a` is before `b`, allowing for wraparound.
+bool is_before(uint32_t a, uint32_t b) { return int32_t(a - b) < 0; }
+
+/// Sets socket buffer size, and warns if the kernel limit is lower.
+void set_buffer_size(int fd, int option, const char *name, const char *limit) {
+  const int buffer_size = 8 << 20;
+  setsockopt(fd, SOL_SOCKET, option, &buffer_size, sizeof(buffer_size));
+  // Linux reports double the requested size (up to the limit)
+  int actual_size = 0;
+  socklen_t length = sizeof(actual_size);
+  if ((getsockopt(fd, SOL_SOCKET, option, &actual_size, &length) == 0) &&
+      (actual_size < buffer_size)) {
+    ROS_WARN(
+        "Multicast %s clamped to %d bytes (requested %d), so large frames may "
+        "be dropped. Increase %s.",
+        name, actual_size, buffer_size, limit);
+  }
+}
+}  // namespace
+
+bool MulticastSender::open(const std::string &group, int port, int ttl,
+                           const std::string &interface_address, int mtu) {
+  close();
+  std::memset(&m_address, 0, sizeof(m_address));
+  m_address.sin_family = AF_INET;
+  m_address.sin_port = htons(port);
+  if (!parse_address(group, m_address.sin_addr)) {
+    ROS_WARN("Invalid multicast group %s.", group.c_str());
+    return false;
+  }
+  const int payload_size =
+      mtu - ip_udp_header_size - int(sizeof(MulticastFragmentHeader));
+  if (payload_size <= 0) {
+    ROS_WARN("Invalid multicast mtu %d.", mtu);
+    return false;
+  }
+  m_payload_size = payload_size;
+  m_datagram.resize(sizeof(MulticastFragmentHeader) + m_payload_size);
+
+  m_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (m_fd < 0) {
+    ROS_WARN("Failed to open multicast socket.");
+    return false;
+  }
+  const unsigned char ttl_value = std::min(std::max(ttl, 0), 255);
+  setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl_value,
+             sizeof(ttl_value));
+  if (!interface_address.empty()) {
+    struct in_addr address;
+    if (!parse_address(interface_address, address) ||
+        (setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_IF, &address,
+                    sizeof(address)) < 0)) {
+      ROS_WARN("Invalid multicast interface %s.", interface_address.c_str());
+      close();
+      return false;
+    }
+  }
+  // Large frames are sent in bursts
+  set_buffer_size(m_fd, SO_SNDBUF, "send buffer", "net.core.wmem_max");
+  m_send_time = std::chrono::steady_clock::now();
+  m_is_running = true;
+  m_thread = std::thread([this]() { run(); });
+  return true;
+}
+
+void MulticastSender::close() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_is_running = false;
+  }
+  m_condition_variable.notify_all();
+  if (m_thread.joinable()) m_thread.join();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.clear();
+    m_spare_frames.clear();
+  }
+  if (m_fd >= 0) ::close(m_fd);
+  m_fd = -1;
+}
+
+void MulticastSender::send(std::vector<uint8_t> &frame) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_is_running) return;
+    if (m_queue.size() >= std::max<std::size_t>(max_queue_size, 1)) {
+      m_spare_frames.push_back(std::move(m_queue.front()));
+      m_queue.pop_front();
+      ++m_n_dropped;
+    }
+    m_queue.push_back(std::move(frame));
+    if (m_spare_frames.empty()) {
+      frame.clear();
+    } else {
+      frame.swap(m_spare_frames.back());
+      m_spare_frames.pop_back();
+    }
+  }
+  m_condition_variable.notify_one();
+}
+
+uint64_t MulticastSender::get_n_dropped() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_n_dropped;
+}
+
+void MulticastSender::run() {
+  std::vector<uint8_t> frame;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_condition_variable.wait(
+        lock, [this]() { return !m_is_running || !m_queue.empty(); });
+    if (!m_is_running) break;
+    frame.swap(m_queue.front());
+    m_queue.pop_front();
+    lock.unlock();
+    send_frame(frame);
+    lock.lock();
+    m_spare_frames.push_back(std::vector<uint8_t>());
+    m_spare_frames.back().swap(frame);
+  }
+}
+
+bool MulticastSender::send_frame(const std::vector<uint8_t> &frame) {
+  const uint8_t *const data = frame.data();
+  const std::size_t size = frame.size();
+  const std::size_t n_fragments =
+      std::max<std::size_t>((size + m_payload_size - 1) / m_payload_size, 1);
+  if (n_fragments > 0xFFFF) return false;
+
+  MulticastFragmentHeader header;
+  header.magic = fragment_magic;
+  header.frame_index = m_frame_index++;
+  header.frame_size = size;
+  header.n_fragments = n_fragments;
+  bool success = true;
+  for (std::size_t i = 0; i < n_fragments; ++i) {
+    const std::size_t offset = i * m_payload_size;
+    const std::size_t payload_size =
+        std::min(m_payload_size, size - std::min(offset, size));
+    header.offset = offset;
+    header.fragment_index = i;
+    std::memcpy(m_datagram.data(), &header, sizeof(header));
+    std::memcpy(m_datagram.data() + sizeof(header), data + offset,
+                payload_size);
+    if ((max_rate > 0.0) &&
+        !pace(ip_udp_header_size + sizeof(header) + payload_size))
+      return false;
+    if (sendto(m_fd, m_datagram.data(), sizeof(header) + payload_size, 0,
+               (const struct sockaddr *)&m_address, sizeof(m_address)) < 0)
+      success = false;
+  }
+  return success;
+}
+
+bool MulticastSender::pace(std::size_t size) {
+  using Clock = std::chrono::steady_clock;
+  const auto to_duration = [this](double n_bytes) {
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(n_bytes / max_rate));
+  };
+  // Queue up to `max_burst` bytes before sleeping, since sleeps are coarse
+  const auto now = Clock::now();
+  const auto burst_duration = to_duration(max_burst);
+  if (m_send_time - now > burst_duration) {
+    // Wake up on close
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_condition_variable.wait_until(lock, m_send_time - burst_duration,
+                                        [this]() { return !m_is_running; }))
+      return false;
+  }
+  m_send_time = std::max(m_send_time, now) + to_duration(size);
+  return true;
+}
+
+bool MulticastReceiver::open(const std::string &group, int port,
+                             const std::string &interface_address) {
+  close();
+  struct ip_mreq request;
+  std::memset(&request, 0, sizeof(request));
+  request.imr_interface.s_addr = htonl(INADDR_ANY);
+  if (!parse_address(group, request.imr_multiaddr) ||
+      (!interface_address.empty() &&
+       !parse_address(interface_address, request.imr_interface))) {
+    ROS_WARN("Invalid multicast address %s.", group.c_str());
+    return false;
+  }
+
+  m_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (m_fd < 0) {
+    ROS_WARN("Failed to open multicast socket.");
+    return false;
+  }
+  // Allow multiple receivers on the same host
+  const int reuse = 1;
+  setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  set_buffer_size(m_fd, SO_RCVBUF, "receive buffer", "net.core.rmem_max");
+
+  struct sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr = request.imr_multiaddr;
+  if ((bind(m_fd, (const struct sockaddr *)&address, sizeof(address)) < 0) ||
+      (setsockopt(m_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request,
+                  sizeof(request)) < 0)) {
+    ROS_WARN("Failed to join multicast group %s:%d.", group.c_str(), port);
+    close();
+    return false;
+  }
+  m_datagram.resize(0xFFFF);
+  return true;
+}
+
+void MulticastReceiver::close() {
+  if (m_fd >= 0) ::close(m_fd);
+  m_fd = -1;
+  m_reassembler.clear();
+}
+
+bool MulticastReceiver::receive(int timeout, std::vector<uint8_t> &frame) {
+  if (!is_open()) return false;
+  struct pollfd poll_fd = {m_fd, POLLIN, 0};
+  if (poll(&poll_fd, 1, timeout) <= 0) return false;
+
+  ssize_t size;
+  while ((size = recv(m_fd, m_datagram.data(), m_datagram.size(),
+                      MSG_DONTWAIT)) > 0) {
+    if (m_reassembler.add_datagram(m_datagram.data(), size, frame))
+      return true;
+  }
+  return false;
+}
+
+bool FrameReassembler::add_datagram(const uint8_t *datagram, std::size_t size,
+                                    std::vector<uint8_t> &frame) {
+  MulticastFragmentHeader header;
+  if (size < sizeof(header)) return false;
+  std::memcpy(&header, datagram, sizeof(header));
+  if ((header.magic != fragment_magic) || (header.n_fragments == 0) ||
+      (header.fragment_index >= header.n_fragments))
+    return false;
+  const std::size_t payload_size = size - sizeof(header);
+  if (std::size_t(header.offset) + payload_size > header.frame_size)
+    return false;
+
+  // Find frame
+  auto iter = std::find_if(m_frames.begin(), m_frames.end(),
+                           [&header](const PartialFrame &other) {
+                             return other.frame_index == header.frame_index;
+                           });
+  if (iter == m_frames.end()) {
+    if (m_frames.size() >= max_partial_frames) {
+      m_frames.erase(m_frames.begin());
+      ++m_n_dropped;
+    }
+    m_frames.emplace_back();
+    iter = m_frames.end() - 1;
+    iter->frame_index = header.frame_index;
+    iter->n_fragments = header.n_fragments;
+    iter->data.resize(header.frame_size);
+    iter->is_received.assign(header.n_fragments, false);
+  }
+  auto &partial_frame = *iter;
+  if ((header.n_fragments != partial_frame.n_fragments) ||
+      (header.frame_size != partial_frame.data.size()) ||
+      partial_frame.is_received[header.fragment_index])
+    return false;
+
+  std::memcpy(partial_frame.data.data() + header.offset,
+              datagram + sizeof(header), payload_size);
+  partial_frame.is_received[header.fragment_index] = true;
+  ++partial_frame.n_received;
+  if (partial_frame.n_received < partial_frame.n_fragments) return false;
+
+  frame.swap(partial_frame.data);
+  m_frames.erase(iter);
+  drop_before(header.frame_index);
+  return true;
+}
+
+void FrameReassembler::drop_before(uint32_t frame_index) {
+  const auto iter =
+      std::remove_if(m_frames.begin(), m_frames.end(),
+                     [frame_index](const PartialFrame &frame) {
+                       return is_before(frame.frame_index, frame_index);
+                     });
+  m_n_dropped += m_frames.end() - iter;
+  m_frames.erase(iter, m_frames.end());
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <netinet/in.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cepton_ros {
+
+/// Datagram header. Fields are little endian.
+struct MulticastFragmentHeader {
+  std::array<char, 4> magic;
+  uint32_t frame_index;     ///< Per sender frame counter.
+  uint32_t frame_size;      ///< [bytes]
+  uint32_t offset;          ///< Fragment offset in frame [bytes].
+  uint16_t fragment_index;
+  uint16_t n_fragments;
+};
+
+/// Sends serialized frames to a UDP multicast group.
+/**
+ * Each frame is split into datagrams of at most `mtu` bytes (including IP and
+ * UDP headers), so that datagrams are not fragmented by IP. Frames are sent
+ * once, regardless of the number of receivers.
+ *
+ * Frames are queued, and sent by a dedicated thread, so that callers are not
+ * blocked. If more than `max_queue_size` frames are queued (the link is
+ * slower than the sensors), the oldest frame is dropped.
+ *
+ * A full frame is thousands of datagrams, which can overflow switch and
+ * receiver buffers if sent back to back. If `max_rate` is set, datagrams are
+ * paced to that rate (the sending thread sleeps), with bursts of up to
+ * `max_burst` bytes.
+ */
+class MulticastSender {
+ public:
+  ~MulticastSender() { close(); }
+
+  /// Opens socket, and starts sending thread. If `interface_address` is
+  /// empty, uses default interface.
+  bool open(const std::string &group, int port, int ttl,
+            const std::string &interface_address, int mtu);
+  /// Stops sending thread, and drops queued frames.
+  void close();
+  bool is_open() const { return m_fd >= 0; }
+
+  /// Queues frame, and swaps `frame` with a spare buffer, so that its
+  /// capacity is reused without copies.
+  void send(std::vector<uint8_t> &frame);
+
+  /// Returns number of frames dropped because the queue was full.
+  uint64_t get_n_dropped() const;
+
+ private:
+  void run();
+  /// Returns false if any datagram could not be sent.
+  bool send_frame(const std::vector<uint8_t> &frame);
+  /// Waits until datagram of `size` bytes can be sent. Returns false if
+  /// sender was closed.
+  bool pace(std::size_t size);
+
+ public:
+  // Options
+  double max_rate = 0.0;            ///< [bytes/second] (0: unlimited).
+  std::size_t max_burst = 1 << 16;  ///< [bytes]
+  std::size_t max_queue_size = 2;   ///< [frames]
+
+ private:
+  int m_fd = -1;
+  struct sockaddr_in m_address;
+  std::size_t m_payload_size = 0;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition_variable;
+  bool m_is_running = false;
+  std::deque<std::vector<uint8_t>> m_queue;
+  /// Buffers of sent frames.
+  std::vector<std::vector<uint8_t>> m_spare_frames;
+  uint64_t m_n_dropped = 0;
+  std::thread m_thread;
+
+  // Sending thread state
+  uint32_t m_frame_index = 0;
+  std::vector<uint8_t> m_datagram;
+  /// Time when queued bytes are sent, at `max_rate`.
+  std::chrono::steady_clock::time_point m_send_time;
+};
+
+/// Reassembles frames from datagrams.
+/**
+ * Frames with missing fragments are dropped when a later frame completes, or
+ * when more than `max_partial_frames` frames are in progress.
+ */
+class FrameReassembler {
+ public:
+  /// Adds datagram. Returns true if a frame was completed, and sets `frame` to
+  /// it.
+  bool add_datagram(const uint8_t *datagram, std::size_t size,
+                    std::vector<uint8_t> &frame);
+  /// Drops frames in progress.
+  void clear() { m_frames.clear(); }
+
+  uint64_t get_n_dropped() const { return m_n_dropped; }
+
+ public:
+  // Options
+  std::size_t max_partial_frames = 4;
+
+ private:
+  struct PartialFrame {
+    uint32_t frame_index = 0;
+    uint16_t n_fragments = 0;
+    uint16_t n_received = 0;
+    std::vector<uint8_t> data;
+    std::vector<bool> is_received;
+  };
+
+  /// Drops frames started before `frame_index`.
+  void drop_before(uint32_t frame_index);
+
+ private:
+  std::vector<PartialFrame> m_frames;
+  uint64_t m_n_dropped = 0;
+};
+
+/// Receives and reassembles frames from a UDP multicast group.
+class MulticastReceiver {
+ public:
+  ~MulticastReceiver() { close(); }
+
+  bool open(const std::string &group, int port,
+            const std::string &interface_address);
+  void close();
+  bool is_open() const { return m_fd >= 0; }
+
+  /// Waits up to `timeout` milliseconds for datagrams. Returns true if a
+  /// frame was completed, and sets `frame` to it.
+  bool receive(int timeout, std::vector<uint8_t> &frame);
+
+  uint64_t get_n_dropped() const { return m_reassembler.get_n_dropped(); }
+
+ private:
+  int m_fd = -1;
+  std::vector<uint8_t> m_datagram;
+  FrameReassembler m_reassembler;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,60 @@
+#include "occlusion_mask.hpp"
+
+#include <limits>
+
+#include "grid_file.hpp"
+
+namespace cepton_ros {
+
+namespace {
+const GridFile grid_file = {{{'C', 'O', 'M', '2'}}, "occlusion mask"};
+}  // namespace
+
+void OcclusionMask::add_point(const cepton_sdk::util::SensorPoint &point) {
+  const int i = grid.get_index(point.image_x, point.image_z);
+  if (i < 0) return;
+  if (m_n_points[i] == std::numeric_limits<uint16_t>::max()) return;
+  ++m_n_points[i];
+  if (point.valid && (point.distance < max_distance)) ++m_n_near_points[i];
+}
+
+bool OcclusionMask::next_frame() {
+  if (!is_calibrating()) return false;
+  ++m_n_frames;
+  if (m_n_frames < calibration_frames) return false;
+
+  m_bits.assign((grid.size() + 63) / 64, 0);
+  for (int i = 0; i < grid.size(); ++i) {
+    if ((m_n_points[i] >= min_points) &&
+        (m_n_near_points[i] >= min_ratio * m_n_points[i]))
+      m_bits[i >> 6] |= uint64_t(1) << (i & 63);
+  }
+  std::vector<uint16_t>().swap(m_n_points);
+  std::vector<uint16_t>().swap(m_n_near_points);
+  return true;
+}
+
+void OcclusionMask::start_calibration() {
+  m_bits.clear();
+  m_n_frames = 0;
+  m_n_points.assign(grid.size(), 0);
+  m_n_near_points.assign(grid.size(), 0);
+}
+
+bool OcclusionMask::load(const std::string &path) {
+  std::vector<uint64_t> bits((grid.size() + 63) / 64);
+  int64_t value;
+  if (!grid_file.load(path, grid, bits.data(), bits.size() * sizeof(uint64_t),
+                      value))
+    return false;
+  m_bits.swap(bits);
+  return true;
+}
+
+bool OcclusionMask::save(const std::string &path) const {
+  if (m_bits.empty()) return false;
+  return grid_file.save(path, grid, m_bits.data(),
+                        m_bits.size() * sizeof(uint64_t), 0);
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <cepton_sdk_util.hpp>
+
+#include "cepton_ros/image_grid.hpp"
+
+namespace cepton_ros {
+
+/// Per sensor image space mask of self occluded cells (vehicle body, mounts).
+/**
+ * Calibrated while stationary: cells where at least `min_ratio` of returns
+ * are closer than `max_distance` are masked. At runtime, returns in masked
+ * cells that are closer than `max_distance` are rejected with a bitmap
+ * lookup.
+ */
+class OcclusionMask {
+ public:
+  bool empty() const { return m_bits.empty(); }
+
+  bool is_masked(float image_x, float image_z, float distance) const {
+    if (m_bits.empty() || (distance >= max_distance)) return false;
+    const int i = grid.get_index(image_x, image_z);
+    if (i < 0) return false;
+    return (m_bits[i >> 6] >> (i & 63)) & 1;
+  }
+
+  /// Adds calibration point.
+  void add_point(const cepton_sdk::util::SensorPoint &point);
+  /// Finishes calibration frame. Returns true if calibration finished.
+  bool next_frame();
+  bool is_calibrating() const { return !m_n_points.empty(); }
+  /// Clears mask, and starts calibration.
+  void start_calibration();
+
+  bool load(const std::string &path);
+  bool save(const std::string &path) const;
+
+ public:
+  // Options
+  ImageGrid grid{0.005f};
+  float max_distance = 3.0f;  ///< [meters]
+  float min_ratio = 0.9f;
+  int min_points = 5;  ///< Minimum calibration points per masked cell.
+  int calibration_frames = 100;
+
+ private:
+  std::vector<uint64_t> m_bits;
+
+  // Calibration
+  int m_n_frames = 0;
+  std::vector<uint16_t> m_n_points;
+  std::vector<uint16_t> m_n_near_points;
+};
+
+}  // namespace cepton_ros
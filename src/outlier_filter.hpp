@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <cepton_sdk_util.hpp>
+
+#include "cepton_ros/image_grid.hpp"
+#include "cepton_ros/point.hpp"
+
+namespace cepton_ros {
+
+/// Image space statistical outlier removal.
+/**
+ * Valid points are binned into image grid cells, so the neighborhood covers
+ * neighboring segments and measurements. Per cell point count, distance sum
+ * and squared distance sum are accumulated into a summed-area table, so the
+ * statistics of each point's window are found in O(1), independent of the
+ * window radius.
+ *
+ * A point is an outlier if its window (excluding itself) has fewer than
+ * `min_neighbors` points, or if its distance differs from the window mean by
+ * more than `std_ratio` standard deviations plus `min_tolerance`. Invalid
+ * points are kept. The table only covers the bounding box of occupied cells
+ * (plus the window radius), and only occupied cells are reset, so cost is
+ * O(points + bounding box cells) per frame.
+ */
+class OutlierFilter {
+ public:
+  /// Copies frame to output, dropping outliers.
+  void filter(const CeptonPointCloud &input, CeptonPointCloud &output) {
+    if (int(m_cell_sums.size()) != grid.size())
+      m_cell_sums.assign(grid.size(), Sums());
+    m_cells.resize(input.size());
+
+    // Accumulate cells
+    int x_0 = grid.width, x_1 = -1, z_0 = grid.height, z_1 = -1;
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      const auto &point = input.points[i];
+      int i_x, i_z;
+      if (!point.valid ||
+          !grid.get_cell(point.image_x, point.image_z, i_x, i_z)) {
+        m_cells[i] = -1;
+        continue;
+      }
+      const int cell = grid.get_index(i_x, i_z);
+      m_cells[i] = cell;
+      auto &sums = m_cell_sums[cell];
+      if (sums.n == 0.0) {
+        m_occupied.push_back(cell);
+        x_0 = std::min(x_0, i_x);
+        x_1 = std::max(x_1, i_x);
+        z_0 = std::min(z_0, i_z);
+        z_1 = std::max(z_1, i_z);
+      }
+      sums.add(point.distance);
+    }
+
+    // Summed-area table of bounding box, with a leading row and column of
+    // zeros. Windows are clipped to the grid, so also to the box.
+    if (m_occupied.empty()) x_0 = x_1 = z_0 = z_1 = 0;
+    x_0 = std::max(x_0 - radius, 0);
+    x_1 = std::min(x_1 + radius, grid.width - 1);
+    z_0 = std::max(z_0 - radius, 0);
+    z_1 = std::min(z_1 + radius, grid.height - 1);
+    const int table_width = std::max(x_1 - x_0 + 2, 1);
+    const int table_height = std::max(z_1 - z_0 + 2, 1);
+    m_table.resize(std::size_t(table_width) * table_height);
+    std::fill(m_table.begin(), m_table.begin() + table_width, Sums());
+    for (int z = z_0; z <= z_1; ++z) {
+      const Sums *const above = &m_table[(z - z_0) * table_width];
+      Sums *const row = &m_table[(z - z_0 + 1) * table_width];
+      Sums row_sums;
+      row[0] = Sums();
+      for (int x = x_0; x <= x_1; ++x) {
+        row_sums += m_cell_sums[grid.get_index(x, z)];
+        row[x - x_0 + 1] = above[x - x_0 + 1];
+        row[x - x_0 + 1] += row_sums;
+      }
+    }
+    const auto get_table = [&](int x, int z) -> const Sums & {
+      return m_table[(z - z_0) * table_width + (x - x_0)];
+    };
+
+    output.header = input.header;
+    output.clear();
+    for (std::size_t i = 0; i < input.size(); ++i) {
+      const auto &point = input.points[i];
+      const int cell = m_cells[i];
+      if (cell < 0) {
+        output.points.push_back(point);
+        continue;
+      }
+      const int i_x = cell % grid.width;
+      const int i_z = cell / grid.width;
+      const int w_x_0 = std::max(i_x - radius, x_0);
+      const int w_x_1 = std::min(i_x + radius, x_1) + 1;
+      const int w_z_0 = std::max(i_z - radius, z_0);
+      const int w_z_1 = std::min(i_z + radius, z_1) + 1;
+      Sums sums = get_table(w_x_1, w_z_1);
+      sums -= get_table(w_x_0, w_z_1);
+      sums -= get_table(w_x_1, w_z_0);
+      sums += get_table(w_x_0, w_z_0);
+      if (!is_outlier(sums, point.distance)) output.points.push_back(point);
+    }
+    output.height = 1;
+    output.width = output.points.size();
+
+    // Reset occupied cells
+    for (const int cell : m_occupied) m_cell_sums[cell] = Sums();
+    m_occupied.clear();
+  }
+
+  /// Releases buffers.
+  void reset() {
+    std::vector<Sums>().swap(m_cell_sums);
+    std::vector<int>().swap(m_occupied);
+    std::vector<Sums>().swap(m_table);
+    std::vector<int>().swap(m_cells);
+  }
+
+ private:
+  struct Sums {
+    double n = 0.0;
+    double sum = 0.0;
+    double sum_squared = 0.0;
+
+    void add(double distance) {
+      n += 1.0;
+      sum += distance;
+      sum_squared += distance * distance;
+    }
+    Sums &operator+=(const Sums &other) {
+      n += other.n;
+      sum += other.sum;
+      sum_squared += other.sum_squared;
+      return *this;
+    }
+    Sums &operator-=(const Sums &other) {
+      n -= other.n;
+      sum -= other.sum;
+      sum_squared -= other.sum_squared;
+      return *this;
+    }
+  };
+
+  bool is_outlier(const Sums &sums, float distance) const {
+    // Exclude point
+    const double n = sums.n - 1.0;
+    if (n < min_neighbors - 0.5) return true;
+    const double mean = (sums.sum - distance) / n;
+    const double variance =
+        std::max((sums.sum_squared - double(distance) * distance) / n -
+                     mean * mean,
+                 0.0);
+    return std::abs(distance - mean) >
+           std_ratio * std::sqrt(variance) + min_tolerance;
+  }
+
+ public:
+  // Options
+  ImageGrid grid;
+  int radius = 1;  ///< Window radius [cells].
+  int min_neighbors = 2;
+  float std_ratio = 2.0f;
+  float min_tolerance = 0.5f;  ///< [meters]
+
+ private:
+  std::vector<Sums> m_cell_sums;  ///< Zero, except for occupied cells.
+  std::vector<int> m_occupied;    ///< Occupied cells.
+  std::vector<Sums> m_table;      ///< Summed-area table of bounding box.
+  std::vector<int> m_cells;       ///< Per point cell (or -1).
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,72 @@
+#include "perf_counters.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace cepton_ros {
+
+namespace {
+int open_counter(uint64_t config, int group_fd) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // Calling thread, any cpu
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+}  // namespace
+
+bool PerfCounters::open() {
+  close();
+  const std::array<uint64_t, 4> configs = {
+      {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+       PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES}};
+  for (std::size_t i = 0; i < configs.size(); ++i) {
+    m_fds[i] = open_counter(configs[i], m_fds[0]);
+    if (m_fds[i] < 0) {
+      close();
+      return false;
+    }
+  }
+  return true;
+}
+
+void PerfCounters::close() {
+  for (int &fd : m_fds) {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+  }
+}
+
+bool PerfCounters::read(Values &values) const {
+  if (!is_open()) return false;
+  struct {
+    uint64_t n;
+    uint64_t values[4];
+  } buffer;
+  if (::read(m_fds[0], &buffer, sizeof(buffer)) != sizeof(buffer)) return false;
+  values.cycles = buffer.values[0];
+  values.instructions = buffer.values[1];
+  values.cache_misses = buffer.values[2];
+  values.branch_misses = buffer.values[3];
+  return true;
+}
+
+PerfCounters &PerfCounters::get_thread_counters() {
+  thread_local PerfCounters counters;
+  if (!counters.m_has_opened) {
+    counters.m_has_opened = true;
+    counters.open();
+  }
+  return counters;
+}
+
+}  // namespace cepton_ros
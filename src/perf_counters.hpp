@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace cepton_ros {
+
+/// Hardware performance counters of the calling thread (Linux perf events).
+/**
+ * Counts user space cycles, instructions, cache misses, and branch misses, as
+ * one group, so that the counters are scheduled together.
+ */
+class PerfCounters {
+ public:
+  struct Values {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cache_misses = 0;
+    uint64_t branch_misses = 0;
+
+    Values &operator+=(const Values &other) {
+      cycles += other.cycles;
+      instructions += other.instructions;
+      cache_misses += other.cache_misses;
+      branch_misses += other.branch_misses;
+      return *this;
+    }
+    Values operator-(const Values &other) const {
+      Values result;
+      result.cycles = cycles - other.cycles;
+      result.instructions = instructions - other.instructions;
+      result.cache_misses = cache_misses - other.cache_misses;
+      result.branch_misses = branch_misses - other.branch_misses;
+      return result;
+    }
+  };
+
+  PerfCounters() = default;
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+  ~PerfCounters() { close(); }
+
+  /// Opens counters for calling thread. Fails if not permitted (see
+  /// `/proc/sys/kernel/perf_event_paranoid`) or not supported.
+  bool open();
+  void close();
+  bool is_open() const { return m_fds[0] >= 0; }
+
+  bool read(Values &values) const;
+
+  /// Returns counters of calling thread, opening them on first call.
+  static PerfCounters &get_thread_counters();
+
+ private:
+  std::array<int, 4> m_fds{{-1, -1, -1, -1}};
+  bool m_has_opened = false;
+};
+
+/// Driver pipeline stages.
+enum PipelineStage {
+  STAGE_COPY,
+  STAGE_CONVERT,
+  STAGE_FILTER,
+  STAGE_SERIALIZE,
+  STAGE_PUBLISH,
+  N_STAGES,
+};
+
+/// Per frame counters of each pipeline stage.
+struct StageCounters {
+  std::array<PerfCounters::Values, N_STAGES> stages;
+
+  void clear() { stages.fill(PerfCounters::Values()); }
+};
+
+/// Adds counters of scope to stage. Does nothing if `counters` is null.
+/**
+ * Each scope costs two `read` system calls. Scopes must not be nested.
+ */
+class StageScope {
+ public:
+  StageScope(StageCounters *counters, PipelineStage stage)
+      : m_counters(counters), m_stage(stage) {
+    if (!m_counters) return;
+    if (!PerfCounters::get_thread_counters().read(m_start))
+      m_counters = nullptr;
+  }
+
+  ~StageScope() { stop(); }
+
+  /// Ends scope early.
+  void stop() {
+    if (!m_counters) return;
+    PerfCounters::Values end;
+    if (PerfCounters::get_thread_counters().read(end))
+      m_counters->stages[m_stage] += end - m_start;
+    m_counters = nullptr;
+  }
+
+ private:
+  StageCounters *m_counters;
+  PipelineStage m_stage;
+  PerfCounters::Values m_start;
+};
+
+}  // namespace cepton_ros
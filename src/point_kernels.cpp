@@ -0,0 +1,153 @@
+#include "point_kernels.hpp"
+
+#include <cmath>
+
+namespace cepton_ros {
+
+namespace {
+/// Row major 3x4 transform.
+struct Matrix {
+  explicit Matrix(const cepton_sdk::util::CompiledTransform &transform)
+      : r{{transform.rotation_m00, transform.rotation_m01,
+           transform.rotation_m02},
+          {transform.rotation_m10, transform.rotation_m11,
+           transform.rotation_m12},
+          {transform.rotation_m20, transform.rotation_m21,
+           transform.rotation_m22}},
+        t{transform.translation[0], transform.translation[1],
+          transform.translation[2]} {}
+
+  float r[3][3];
+  float t[3];
+};
+
+/// Computes transformed point direction, per meter of distance.
+inline void get_direction(const Matrix &m, float image_x, float image_z,
+                          float *const direction) {
+  const float y =
+      1.0f / std::sqrt(image_x * image_x + image_z * image_z + 1.0f);
+  const float x = -image_x * y;
+  const float z = -image_z * y;
+  for (int i = 0; i < 3; ++i)
+    direction[i] = m.r[i][0] * x + m.r[i][1] * y + m.r[i][2] * z;
+}
+
+inline void convert_point(const cepton_sdk::SensorImagePoint &image_point,
+                          const Matrix &m, const float *const direction,
+                          cepton_sdk::util::SensorPoint &point) {
+  *(cepton_sdk::SensorImagePoint *)(&point) = image_point;
+  const float distance = image_point.distance;
+  point.x = direction[0] * distance + m.t[0];
+  point.y = direction[1] * distance + m.t[1];
+  point.z = direction[2] * distance + m.t[2];
+}
+
+/// Converts returns of a segment, which usually share a direction.
+template <int RETURN_COUNT>
+inline void convert_segment(
+    const Matrix &m, const cepton_sdk::SensorImagePoint *const image_points,
+    cepton_sdk::util::SensorPoint *const points) {
+  float image_x = image_points[0].image_x;
+  float image_z = image_points[0].image_z;
+  float direction[3];
+  get_direction(m, image_x, image_z, direction);
+  for (int i_return = 0; i_return < RETURN_COUNT; ++i_return) {
+    const auto &image_point = image_points[i_return];
+    if ((i_return > 0) && ((image_point.image_x != image_x) ||
+                           (image_point.image_z != image_z))) {
+      image_x = image_point.image_x;
+      image_z = image_point.image_z;
+      get_direction(m, image_x, image_z, direction);
+    }
+    convert_point(image_point, m, direction, points[i_return]);
+  }
+}
+
+void convert_each(const Matrix &m, std::size_t n_points,
+                  const cepton_sdk::SensorImagePoint *const image_points,
+                  cepton_sdk::util::SensorPoint *const points) {
+  for (std::size_t i = 0; i < n_points; ++i) {
+    const auto &image_point = image_points[i];
+    float direction[3];
+    get_direction(m, image_point.image_x, image_point.image_z, direction);
+    convert_point(image_point, m, direction, points[i]);
+  }
+}
+
+void convert_generic(const cepton_sdk::util::CompiledTransform &transform,
+                     std::size_t n_points,
+                     const cepton_sdk::SensorImagePoint *const image_points,
+                     cepton_sdk::util::SensorPoint *const points) {
+  convert_each(Matrix(transform), n_points, image_points, points);
+}
+
+template <int SEGMENT_COUNT, int RETURN_COUNT>
+void convert(const cepton_sdk::util::CompiledTransform &transform,
+             std::size_t n_points,
+             const cepton_sdk::SensorImagePoint *const image_points,
+             cepton_sdk::util::SensorPoint *const points) {
+  const Matrix m(transform);
+  constexpr int stride = SEGMENT_COUNT * RETURN_COUNT;
+  const std::size_t n_measurements = n_points / stride;
+  for (std::size_t i_measurement = 0; i_measurement < n_measurements;
+       ++i_measurement) {
+    const std::size_t i_0 = i_measurement * stride;
+    for (int i_segment = 0; i_segment < SEGMENT_COUNT; ++i_segment) {
+      const std::size_t i = i_0 + i_segment * RETURN_COUNT;
+      convert_segment<RETURN_COUNT>(m, image_points + i, points + i);
+    }
+  }
+  // Partial measurement
+  const std::size_t i_end = n_measurements * stride;
+  convert_each(m, n_points - i_end, image_points + i_end, points + i_end);
+}
+
+template <int STRIDE>
+int find_frame(cepton_sdk::util::FrameDetector &frame_detector,
+               const cepton_sdk::SensorImagePoint *const image_points,
+               int i_start, int i_end, int /* stride */) {
+  for (int i = i_start; i < i_end; i += STRIDE) {
+    if (frame_detector.add_point(image_points[i])) return i;
+  }
+  return -1;
+}
+
+int find_frame_generic(cepton_sdk::util::FrameDetector &frame_detector,
+                       const cepton_sdk::SensorImagePoint *const image_points,
+                       int i_start, int i_end, int stride) {
+  for (int i = i_start; i < i_end; i += stride) {
+    if (frame_detector.add_point(image_points[i])) return i;
+  }
+  return -1;
+}
+
+#define CEPTON_ROS_POINT_KERNELS(SEGMENT_COUNT, RETURN_COUNT)           \
+  {                                                                     \
+    SEGMENT_COUNT, RETURN_COUNT, &convert<SEGMENT_COUNT, RETURN_COUNT>, \
+        &find_frame<SEGMENT_COUNT * RETURN_COUNT>                       \
+  }
+
+/// Single and dual return geometries, with the segment counts of current
+/// models (HR80, SORA, VISTA).
+const PointKernels point_kernels_table[] = {
+    CEPTON_ROS_POINT_KERNELS(1, 1), CEPTON_ROS_POINT_KERNELS(1, 2),
+    CEPTON_ROS_POINT_KERNELS(2, 1), CEPTON_ROS_POINT_KERNELS(2, 2),
+    CEPTON_ROS_POINT_KERNELS(4, 1), CEPTON_ROS_POINT_KERNELS(4, 2),
+    CEPTON_ROS_POINT_KERNELS(8, 1), CEPTON_ROS_POINT_KERNELS(8, 2),
+};
+
+#undef CEPTON_ROS_POINT_KERNELS
+}  // namespace
+
+const PointKernels &get_point_kernels(int segment_count, int return_count) {
+  for (const auto &kernels : point_kernels_table) {
+    if ((kernels.segment_count == segment_count) &&
+        (kernels.return_count == return_count))
+      return kernels;
+  }
+  static const PointKernels generic_kernels = {0, 0, &convert_generic,
+                                               &find_frame_generic};
+  return generic_kernels;
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+
+#include <cepton_sdk_util.hpp>
+
+namespace cepton_ros {
+
+/// Points converted per kernel call, so that per point stages that follow
+/// find the block in L1 cache.
+constexpr std::size_t point_kernel_block_size = 256;
+
+/// Per frame kernels, specialized for sensor geometry.
+/**
+ * Image points are ordered by measurement, then segment, then return. The
+ * specialized kernels have compile time segment and return counts, so that
+ * the loops are fully unrolled, and the transformed direction of a segment is
+ * computed once for all of its returns.
+ */
+struct PointKernels {
+  int segment_count;  ///< 0 if generic.
+  int return_count;   ///< 0 if generic.
+
+  /// Converts image points to points, and applies transform.
+  /**
+   * Equivalent to `cepton_sdk::util::convert_sensor_image_point_to_point`,
+   * followed by `transform.apply`. The rotation is applied to the unit
+   * direction, and the transform is loaded once per call. Returns only share
+   * a direction if their image coordinates are equal, so `image_points` does
+   * not need to start at a measurement.
+   */
+  void (*convert)(const cepton_sdk::util::CompiledTransform &transform,
+                  std::size_t n_points,
+                  const cepton_sdk::SensorImagePoint *const image_points,
+                  cepton_sdk::util::SensorPoint *const points);
+
+  /// Adds first point of each measurement in `[i_start, i_end)` to frame
+  /// detector. Returns index of point where frame was found, or -1.
+  /**
+   * `stride` is only used by generic kernels.
+   */
+  int (*find_frame)(cepton_sdk::util::FrameDetector &frame_detector,
+                    const cepton_sdk::SensorImagePoint *const image_points,
+                    int i_start, int i_end, int stride);
+};
+
+/// Returns kernels for sensor geometry.
+/**
+ * Falls back to generic kernels for unknown geometries. Call once per sensor,
+ * and again if its geometry changes.
+ */
+const PointKernels &get_point_kernels(int segment_count, int return_count);
+
+}  // namespace cepton_ros
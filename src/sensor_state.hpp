@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ros/ros.h>
+#include <cepton_sdk_util.hpp>
+
+#include "cepton_ros/delta_frame.hpp"
+#include "cepton_ros/point.hpp"
+#include "background_model.hpp"
+#include "clock_estimator.hpp"
+#include "frame_statistics.hpp"
+#include "occlusion_mask.hpp"
+#include "outlier_filter.hpp"
+#include "perf_counters.hpp"
+#include "point_kernels.hpp"
+#include "temporal_filter.hpp"
+#include "triple_buffer.hpp"
+
+namespace cepton_ros {
+
+using PointCloudPool = cepton_sdk::util::LargeObjectPool<CeptonPointCloud>;
+
+/// Per sensor driver state.
+/**
+ * Keyed by serial number, so that it survives the sensor reconnecting with a
+ * new handle.
+ */
+struct SensorState {
+  /// Held while processing a frame.
+  std::mutex mutex;
+
+  uint64_t serial_number = 0;
+  cepton_sdk::SensorHandle handle = 0;
+  std::string frame_id;
+
+  int segment_count = 0;
+  int return_count = 0;
+  /// Selected when sensor is attached, or its geometry changes.
+  const PointKernels *kernels = &get_point_kernels(0, 0);
+
+  bool is_alive = false;
+  ros::WallTime last_frame_time;
+
+  /// Sensor clock to host clock mapping.
+  ClockEstimator clock_estimator;
+
+  OcclusionMask occlusion_mask;
+  TemporalFilter temporal_filter;
+  BackgroundModel background_model;
+
+  OutlierFilter outlier_filter;
+  DeltaEncoder delta_encoder;
+
+  /// Current frame statistics.
+  FrameStatisticsAccumulator statistics;
+  /// Current frame pipeline stage counters.
+  StageCounters stage_counters;
+
+  /// Pooled buffer, returned to pool when sensor times out.
+  std::shared_ptr<CeptonPointCloud> point_cloud;
+  /// Frame without outliers, for streams that select the outlier filter.
+  CeptonPointCloud filtered_point_cloud;
+  /// Copy of last published frame, for `cepton/get_latest_frame`.
+  TripleBuffer<CeptonPointCloud> latest_frame;
+
+  // Sub-frame chunks
+  std::unique_ptr<cepton_sdk::util::FrameDetector> frame_detector;
+  /// Streamed points, starting at current frame.
+  std::vector<cepton_sdk::SensorImagePoint> image_points;
+  /// Number of points already published in current frame.
+  std::size_t n_chunk_points = 0;
+  /// Detector frame start, relative to current frame start.
+  int frame_offset = 0;
+  uint32_t frame_index = 0;
+  uint32_t chunk_index = 0;
+  /// A chunk of current frame could not be transformed to target frame.
+  bool is_frame_dropped = false;
+  CeptonPointCloud chunk_point_cloud;
+
+  /// Progressive layer buffer.
+  CeptonPointCloud layer_point_cloud;
+  /// Multicast serialization buffer.
+  std::vector<uint8_t> multicast_buffer;
+
+  /// Discards partial frame.
+  void reset_chunks() {
+    if (frame_detector) frame_detector->reset();
+    image_points.clear();
+    n_chunk_points = 0;
+    frame_offset = 0;
+    if (chunk_index > 0) ++frame_index;
+    chunk_index = 0;
+    is_frame_dropped = false;
+    stage_counters.clear();
+  }
+
+  /// Discards partial frame, and releases per frame buffers and filter state.
+  void release_buffers() {
+    reset_chunks();
+    point_cloud.reset();
+    CeptonPointCloud().swap(filtered_point_cloud);
+    CeptonPointCloud().swap(chunk_point_cloud);
+    CeptonPointCloud().swap(layer_point_cloud);
+    std::vector<cepton_sdk::SensorImagePoint>().swap(image_points);
+    std::vector<uint8_t>().swap(multicast_buffer);
+    temporal_filter.reset();
+    background_model.reset();
+    outlier_filter.reset();
+    delta_encoder.reset();
+  }
+};
+
+}  // namespace cepton_ros
@@ -1,5 +1,7 @@
 #include "subscriber_nodelet.hpp"
 
+#include <cmath>
+
 #include <pluginlib/class_list_macros.h>
 
 PLUGINLIB_EXPORT_CLASS(cepton_ros::SubscriberNodelet, nodelet::Nodelet);
@@ -11,35 +13,143 @@ void SubscriberNodelet::on_sensor_information(
 
 void SubscriberNodelet::on_points(
     const CeptonPointCloud::ConstPtr& point_cloud) {
+  const ros::Time receive_time = ros::Time::now();
+  const int64_t receive_usec = rosutil::to_usec(receive_time);
   const auto& points = point_cloud->points;
-  if (points.size() == 0) return;
-  NODELET_INFO("Received %i points.", (int)points.size());
-  NODELET_INFO("  Timestamp Range: [%li, %li]", (long int)points[0].timestamp,
-               (long int)points[points.size() - 1].timestamp);
-
-  // Print info for first valid point
-  int i;
-  for (i = 0; i < points.size(); ++i) {
-    if (points[i].valid) break;
+
+  Sample sample;
+  sample.receive_time = receive_time;
+  sample.transport_latency =
+      1e-6 * double(receive_usec - int64_t(point_cloud->header.stamp));
+  sample.sensor_latency =
+      (points.empty()) ? NAN
+                       : 1e-6 * double(receive_usec - points.back().timestamp);
+  sample.n_points = points.size();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!frame_statistics_subscriber.getNumPublishers()) {
+    add_sample(point_cloud->header.frame_id, sample);
+    return;
+  }
+  const FrameKey key(point_cloud->header.stamp, point_cloud->header.frame_id);
+  const auto iter = unmatched_serial_numbers.find(key);
+  if (iter == unmatched_serial_numbers.end()) {
+    unmatched_samples[key] = sample;
+    return;
+  }
+  add_sample(std::to_string(iter->second.first), sample);
+  unmatched_serial_numbers.erase(iter);
+}
+
+void SubscriberNodelet::on_frame_statistics(
+    const FrameStatistics::ConstPtr& msg) {
+  const FrameKey key(rosutil::to_usec(msg->header.stamp),
+                     msg->header.frame_id);
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto iter = unmatched_samples.find(key);
+  if (iter == unmatched_samples.end()) {
+    unmatched_serial_numbers[key] =
+        std::make_pair(msg->serial_number, ros::Time::now());
+    return;
+  }
+  add_sample(std::to_string(msg->serial_number), iter->second);
+  unmatched_samples.erase(iter);
+}
+
+void SubscriberNodelet::add_sample(const std::string& name,
+                                   const Sample& sample) {
+  auto& stats = statistics[name];
+  stats.transport_latency.add(sample.transport_latency);
+  if (!std::isnan(sample.sensor_latency))
+    stats.sensor_latency.add(sample.sensor_latency);
+  if (!stats.last_receive_time.isZero() &&
+      (sample.receive_time > stats.last_receive_time))
+    stats.interval.add((sample.receive_time - stats.last_receive_time).toSec());
+  stats.last_receive_time = sample.receive_time;
+  stats.n_points += sample.n_points;
+  stats.n_bytes += sample.n_points * sizeof(cepton_sdk::util::SensorPoint);
+}
+
+void SubscriberNodelet::drop_unmatched(const ros::Time& time) {
+  for (auto iter = unmatched_samples.begin();
+       iter != unmatched_samples.end();) {
+    if (iter->second.receive_time < time)
+      iter = unmatched_samples.erase(iter);
+    else
+      ++iter;
+  }
+  for (auto iter = unmatched_serial_numbers.begin();
+       iter != unmatched_serial_numbers.end();) {
+    if (iter->second.second < time)
+      iter = unmatched_serial_numbers.erase(iter);
+    else
+      ++iter;
+  }
+}
+
+void SubscriberNodelet::on_summary_timer(const ros::WallTimerEvent& event) {
+  const ros::WallTime now = ros::WallTime::now();
+  const double duration = (now - summary_start_time).toSec();
+  summary_start_time = now;
+  if (duration <= 0.0) return;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  drop_unmatched(ros::Time::now() - ros::Duration(duration));
+  for (auto& iter : statistics) {
+    auto& stats = iter.second;
+    // Skip sensors without frames in this period
+    if (!stats.transport_latency.n) continue;
+    NODELET_INFO("%s: %.1f Hz, %.0f points/s, %.2f MB/s", iter.first.c_str(),
+                 stats.transport_latency.n / duration,
+                 stats.n_points / duration, 1e-6 * stats.n_bytes / duration);
+    if (stats.sensor_latency.n) {
+      NODELET_INFO(
+          "  Sensor latency [ms]: p50=%.1f, p90=%.1f, p99=%.1f, max=%.1f",
+          1e3 * stats.sensor_latency.percentile(0.5),
+          1e3 * stats.sensor_latency.percentile(0.9),
+          1e3 * stats.sensor_latency.percentile(0.99),
+          1e3 * stats.sensor_latency.max);
+    }
+    NODELET_INFO(
+        "  Transport latency [ms]: p50=%.2f, p90=%.2f, p99=%.2f, max=%.2f",
+        1e3 * stats.transport_latency.percentile(0.5),
+        1e3 * stats.transport_latency.percentile(0.9),
+        1e3 * stats.transport_latency.percentile(0.99),
+        1e3 * stats.transport_latency.max);
+    if (stats.interval.n) {
+      NODELET_INFO("  Interval [ms]: mean=%.1f, jitter=%.2f, max=%.1f",
+                   1e3 * stats.interval.mean(), 1e3 * stats.interval.stddev(),
+                   1e3 * stats.interval.max);
+    }
+
+    stats.sensor_latency.clear();
+    stats.transport_latency.clear();
+    stats.interval.clear();
+    stats.n_points = 0;
+    stats.n_bytes = 0;
   }
-  const auto& point = points[i];
-  NODELET_INFO("  Point %i:", i);
-  NODELET_INFO("    Image Position: [%.3f, %.3f]", point.image_x, point.image_z);
-  NODELET_INFO("    Distance: %.2f", point.distance);
-  NODELET_INFO("    Position: [%.2f, %.2f, %.2f]", point.x, point.y, point.z);
-  NODELET_INFO("    Intensity: %.2f", point.intensity);
-  NODELET_INFO("    Return Type: %i", (int)point.return_type);
-  NODELET_INFO("    Flags: %i", (int)point.flags);
 }
 
 void SubscriberNodelet::onInit() {
   this->node_handle = getNodeHandle();
   this->private_node_handle = getPrivateNodeHandle();
 
+  double summary_period = 5.0;
+  private_node_handle.param("summary_period", summary_period, summary_period);
+
   sensor_information_subscriber = node_handle.subscribe<SensorInformation>(
       "cepton/sensor_information", 10,
       &SubscriberNodelet::on_sensor_information, this);
   points_subscriber = node_handle.subscribe<CeptonPointCloud>(
-      "cepton/points", 10, &SubscriberNodelet::on_points, this);
+      "cepton/points", 10, &SubscriberNodelet::on_points, this,
+      ros::TransportHints().tcpNoDelay());
+  frame_statistics_subscriber = node_handle.subscribe<FrameStatistics>(
+      "cepton/frame_statistics", 10, &SubscriberNodelet::on_frame_statistics,
+      this);
+
+  summary_start_time = ros::WallTime::now();
+  summary_timer = node_handle.createWallTimer(
+      ros::WallDuration(summary_period), &SubscriberNodelet::on_summary_timer,
+      this);
 }
-}  // namespace cepton_ros
\ No newline at end of file
+}  // namespace cepton_ros
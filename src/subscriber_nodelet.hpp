@@ -1,6 +1,9 @@
 #pragma once
 
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
 
 #include <nodelet/nodelet.h>
 #include <pcl_ros/point_cloud.h>
@@ -8,25 +11,80 @@
 #include <sensor_msgs/PointCloud2.h>
 #include <cepton_sdk_api.hpp>
 
+#include "cepton_ros/FrameStatistics.h"
 #include "cepton_ros/SensorInformation.h"
 #include "cepton_ros/common.hpp"
+#include "cepton_ros/histogram.hpp"
 #include "cepton_ros/point.hpp"
 
 namespace cepton_ros {
 
+/// Latency probe.
+/**
+ * Measures latency, jitter, and throughput of the points topic per sensor,
+ * and prints periodic summaries. Can be loaded in the driver's nodelet
+ * manager (zero copy), or run standalone (TCP).
+ *
+ * Point clouds do not have a serial number, so frames are matched to sensors
+ * by header with `cepton/frame_statistics`. If frame statistics are not
+ * published, frames are grouped by frame id instead.
+ */
 class SubscriberNodelet : public nodelet::Nodelet {
  public:
   void on_sensor_information(const SensorInformation::ConstPtr& msg);
   void on_points(const CeptonPointCloud::ConstPtr& point_cloud);
+  void on_frame_statistics(const FrameStatistics::ConstPtr& msg);
 
  protected:
   void onInit() override;
 
+ private:
+  struct Statistics {
+    /// Last point timestamp -> receive [seconds].
+    Histogram sensor_latency{0.0, 1.0, 1000};
+    /// Header stamp -> receive [seconds].
+    Histogram transport_latency{0.0, 0.1, 1000};
+    /// Inter-frame interval [seconds].
+    Histogram interval{0.0, 1.0, 1000};
+
+    uint64_t n_points = 0;
+    uint64_t n_bytes = 0;
+    ros::Time last_receive_time;
+  };
+
+  /// Measurements of one frame.
+  struct Sample {
+    ros::Time receive_time;
+    double transport_latency;  ///< [seconds]
+    double sensor_latency;     ///< [seconds] NaN if frame is empty.
+    uint64_t n_points;
+  };
+
+  /// Header (stamp, frame id).
+  using FrameKey = std::pair<uint64_t, std::string>;
+
+  void add_sample(const std::string& name, const Sample& sample);
+  /// Drops unmatched samples and serial numbers older than `time`.
+  void drop_unmatched(const ros::Time& time);
+
+  void on_summary_timer(const ros::WallTimerEvent& event);
+
  private:
   ros::NodeHandle node_handle;
   ros::NodeHandle private_node_handle;
 
   ros::Subscriber sensor_information_subscriber;
   ros::Subscriber points_subscriber;
+  ros::Subscriber frame_statistics_subscriber;
+  ros::WallTimer summary_timer;
+
+  std::mutex mutex;
+  ros::WallTime summary_start_time;
+  /// Keyed by serial number, or frame id.
+  std::map<std::string, Statistics> statistics;
+  /// Frames waiting for a serial number.
+  std::map<FrameKey, Sample> unmatched_samples;
+  /// Serial numbers (and receive times) waiting for a frame.
+  std::map<FrameKey, std::pair<uint64_t, ros::Time>> unmatched_serial_numbers;
 };
-}  // namespace cepton_ros
\ No newline at end of file
+}  // namespace cepton_ros
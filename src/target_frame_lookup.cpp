@@ -0,0 +1,109 @@
+#include "target_frame_lookup.hpp"
+
+#include <tf2/exceptions.h>
+
+#include "cepton_ros/common.hpp"
+
+namespace cepton_ros {
+
+cepton_sdk::util::CompiledTransform compose_transforms(
+    const cepton_sdk::util::CompiledTransform &a,
+    const cepton_sdk::util::CompiledTransform &b) {
+  const float a_r[3][3] = {
+      {a.rotation_m00, a.rotation_m01, a.rotation_m02},
+      {a.rotation_m10, a.rotation_m11, a.rotation_m12},
+      {a.rotation_m20, a.rotation_m21, a.rotation_m22}};
+  const float b_r[3][3] = {
+      {b.rotation_m00, b.rotation_m01, b.rotation_m02},
+      {b.rotation_m10, b.rotation_m11, b.rotation_m12},
+      {b.rotation_m20, b.rotation_m21, b.rotation_m22}};
+  // R = R_a * R_b, t = R_a * t_b + t_a
+  float r[3][3];
+  cepton_sdk::util::CompiledTransform result;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      r[i][j] = a_r[i][0] * b_r[0][j] + a_r[i][1] * b_r[1][j] +
+                a_r[i][2] * b_r[2][j];
+    }
+    result.translation[i] = a_r[i][0] * b.translation[0] +
+                            a_r[i][1] * b.translation[1] +
+                            a_r[i][2] * b.translation[2] + a.translation[i];
+  }
+  result.rotation_m00 = r[0][0];
+  result.rotation_m01 = r[0][1];
+  result.rotation_m02 = r[0][2];
+  result.rotation_m10 = r[1][0];
+  result.rotation_m11 = r[1][1];
+  result.rotation_m12 = r[1][2];
+  result.rotation_m20 = r[2][0];
+  result.rotation_m21 = r[2][1];
+  result.rotation_m22 = r[2][2];
+  return result;
+}
+
+void TargetFrameLookup::start(const std::string &target_frame_,
+                              bool is_fixed_) {
+  target_frame = target_frame_;
+  is_fixed = is_fixed_;
+  m_buffer.reset(new tf2_ros::Buffer());
+  m_listener.reset(new tf2_ros::TransformListener(*m_buffer));
+}
+
+bool TargetFrameLookup::lookup(const std::string &source_frame, int64_t stamp,
+                               cepton_sdk::util::CompiledTransform &transform) {
+  if (!m_buffer) return false;
+  const ros::WallTime now = ros::WallTime::now();
+  if (is_fixed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto iter = m_fixed_transforms.find(source_frame);
+    if ((iter != m_fixed_transforms.end()) &&
+        (now < iter->second.refresh_time)) {
+      transform = iter->second.transform;
+      return true;
+    }
+  }
+
+  geometry_msgs::TransformStamped msg;
+  try {
+    const ros::Time time = rosutil::from_usec(stamp);
+    if (is_fixed) {
+      msg = m_buffer->lookupTransform(target_frame, source_frame, ros::Time(0));
+    } else if (m_buffer->canTransform(target_frame, source_frame, time)) {
+      msg = m_buffer->lookupTransform(target_frame, source_frame, time);
+    } else {
+      // E.g. odometry is late, or host clock is not synchronized
+      msg = m_buffer->lookupTransform(target_frame, source_frame, ros::Time(0));
+      ROS_WARN_THROTTLE(
+          5.0,
+          "No transform from %s to %s at frame time. Using latest transform "
+          "(%.3f seconds old).",
+          source_frame.c_str(), target_frame.c_str(),
+          (time - msg.header.stamp).toSec());
+    }
+  } catch (const tf2::TransformException &e) {
+    if (!is_fixed) return false;
+    // Keep cached transform
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto iter = m_fixed_transforms.find(source_frame);
+    if (iter == m_fixed_transforms.end()) return false;
+    transform = iter->second.transform;
+    return true;
+  }
+  const auto &t = msg.transform.translation;
+  const auto &r = msg.transform.rotation;
+  const float translation[3] = {float(t.x), float(t.y), float(t.z)};
+  const float rotation[4] = {float(r.x), float(r.y), float(r.z), float(r.w)};
+  transform =
+      cepton_sdk::util::CompiledTransform::create(translation, rotation);
+
+  if (is_fixed) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto &fixed_transform = m_fixed_transforms[source_frame];
+    fixed_transform.transform = transform;
+    fixed_transform.refresh_time =
+        now + ros::WallDuration(fixed_refresh_period);
+  }
+  return true;
+}
+
+}  // namespace cepton_ros
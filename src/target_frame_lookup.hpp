@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <ros/ros.h>
+#include <tf2_ros/buffer.h>
+#include <tf2_ros/transform_listener.h>
+#include <cepton_sdk_util.hpp>
+
+namespace cepton_ros {
+
+/// Returns transform that applies `b`, then `a`.
+cepton_sdk::util::CompiledTransform compose_transforms(
+    const cepton_sdk::util::CompiledTransform &a,
+    const cepton_sdk::util::CompiledTransform &b);
+
+/// Looks up transforms to target frame through tf2.
+/**
+ * If `is_fixed` is set (e.g. `base_link`), each source frame transform is
+ * cached, and looked up again every `fixed_refresh_period`, so that static
+ * transform changes (e.g. recalibration) are picked up. If the refresh fails,
+ * the cached transform is kept. Otherwise (e.g. `odom`), transforms are looked
+ * up at the frame stamp, falling back to the latest transform with a throttled
+ * warning. Lookups never wait.
+ */
+class TargetFrameLookup {
+ public:
+  /// Starts listening to tf topics.
+  void start(const std::string &target_frame_, bool is_fixed_);
+  bool is_started() const { return (bool)m_buffer; }
+
+  /// Returns false if transform is not available.
+  bool lookup(const std::string &source_frame, int64_t stamp,
+              cepton_sdk::util::CompiledTransform &transform);
+
+ public:
+  std::string target_frame;
+  bool is_fixed = true;
+  float fixed_refresh_period = 1.0f;  ///< [seconds]
+
+ private:
+  struct FixedTransform {
+    cepton_sdk::util::CompiledTransform transform;
+    ros::WallTime refresh_time;
+  };
+
+ private:
+  std::unique_ptr<tf2_ros::Buffer> m_buffer;
+  std::unique_ptr<tf2_ros::TransformListener> m_listener;
+
+  std::mutex m_mutex;
+  std::unordered_map<std::string, FixedTransform> m_fixed_transforms;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <cepton_sdk_util.hpp>
+
+#include "cepton_ros/image_grid.hpp"
+
+namespace cepton_ros {
+
+/// Marks transient returns (dust, rain, spray) invalid.
+/**
+ * Compares each near range, low intensity point to the previous frame's range
+ * image, in a 3x3 cell neighborhood. If the neighborhood was observed, but
+ * has no return at a similar distance, the point is marked invalid.
+ *
+ * The range images are double buffered, and only cells written by points are
+ * reset, so cost is O(points) per frame.
+ */
+class TemporalFilter {
+ public:
+  /// Checks point, and adds it to current frame.
+  void add_point(cepton_sdk::util::SensorPoint &point) {
+    if (m_current.empty()) init();
+
+    int i_x, i_z;
+    if (!grid.get_cell(point.image_x, point.image_z, i_x, i_z)) return;
+    const float distance =
+        (point.valid) ? point.distance : std::numeric_limits<float>::infinity();
+
+    if (point.valid && !point.saturated && (point.distance < max_distance) &&
+        (point.intensity < max_intensity) && !is_consistent(i_x, i_z, distance))
+      point.valid = 0;
+
+    // Keep nearest return. Filtered points are kept, so that persistent
+    // returns are not filtered in the next frame.
+    const int i = grid.get_index(i_x, i_z);
+    float &value = m_current[i];
+    if (std::isnan(value)) {
+      value = distance;
+      m_current_indices.push_back(i);
+    } else {
+      value = std::min(value, distance);
+    }
+  }
+
+  /// Releases buffers. Next frame is not filtered.
+  void reset() {
+    std::vector<float>().swap(m_current);
+    std::vector<float>().swap(m_previous);
+    std::vector<int>().swap(m_current_indices);
+    std::vector<int>().swap(m_previous_indices);
+  }
+
+  /// Finishes current frame.
+  void next_frame() {
+    if (m_current.empty()) return;
+    std::swap(m_current, m_previous);
+    std::swap(m_current_indices, m_previous_indices);
+    for (const int i : m_current_indices)
+      m_current[i] = std::numeric_limits<float>::quiet_NaN();
+    m_current_indices.clear();
+  }
+
+ private:
+  void init() {
+    m_current.assign(grid.size(), std::numeric_limits<float>::quiet_NaN());
+    m_previous = m_current;
+  }
+
+  /// Returns true if neighborhood was not observed, or has a similar return.
+  bool is_consistent(int i_x, int i_z, float distance) const {
+    bool is_observed = false;
+    for (int d_z = -1; d_z <= 1; ++d_z) {
+      for (int d_x = -1; d_x <= 1; ++d_x) {
+        if (!grid.is_valid(i_x + d_x, i_z + d_z)) continue;
+        const float value = m_previous[grid.get_index(i_x + d_x, i_z + d_z)];
+        if (std::isnan(value)) continue;
+        is_observed = true;
+        if (std::abs(value - distance) < distance_tolerance) return true;
+      }
+    }
+    return !is_observed;
+  }
+
+ public:
+  // Options
+  ImageGrid grid;
+  float max_distance = 10.0f;       ///< [meters]
+  float max_intensity = 0.1f;
+  float distance_tolerance = 0.5f;  ///< [meters]
+
+ private:
+  std::vector<float> m_current;
+  std::vector<float> m_previous;
+  std::vector<int> m_current_indices;
+  std::vector<int> m_previous_indices;
+};
+
+}  // namespace cepton_ros
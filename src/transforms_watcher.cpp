@@ -0,0 +1,124 @@
+#include "transforms_watcher.hpp"
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <vector>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <ros/ros.h>
+
+namespace cepton_ros {
+
+namespace {
+std::vector<float> read_floats(const boost::property_tree::ptree &tree,
+                               const std::string &key,
+                               const std::vector<float> &default_value) {
+  const auto child = tree.get_child_optional(key);
+  if (!child) return default_value;
+  std::vector<float> values;
+  for (const auto &iter : *child)
+    values.push_back(iter.second.get_value<float>());
+  if (values.size() != default_value.size())
+    throw std::runtime_error("Invalid " + key);
+  return values;
+}
+}  // namespace
+
+cepton_sdk::util::CompiledTransform TransformsWatcher::parse_transform(
+    const boost::property_tree::ptree &tree) {
+  const auto translation = read_floats(tree, "translation", {0.0f, 0.0f, 0.0f});
+  const auto rotation = read_floats(tree, "rotation", {0.0f, 0.0f, 0.0f, 1.0f});
+  return cepton_sdk::util::CompiledTransform::create(translation.data(),
+                                                     rotation.data());
+}
+
+bool TransformsWatcher::load(const std::string &path,
+                             SensorTransforms &transforms) {
+  transforms.clear();
+  try {
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_json(path, tree);
+    for (const auto &iter : tree) {
+      const uint64_t serial_number = std::stoull(iter.first);
+      transforms[serial_number] = parse_transform(iter.second);
+    }
+  } catch (const std::exception &e) {
+    ROS_WARN("Failed to load transforms %s: %s", path.c_str(), e.what());
+    return false;
+  }
+  return true;
+}
+
+bool TransformsWatcher::start(const std::string &path) {
+  stop();
+  m_path = path;
+  if (!reload()) return false;
+
+  // Watch directory, since editors often replace the file
+  const std::size_t i_separator = m_path.rfind('/');
+  const std::string directory =
+      (i_separator == std::string::npos) ? "." : m_path.substr(0, i_separator);
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0) {
+    ROS_WARN("Failed to watch transforms %s.", m_path.c_str());
+    return true;
+  }
+  if (inotify_add_watch(m_fd, directory.c_str(),
+                        IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+    ROS_WARN("Failed to watch transforms %s.", m_path.c_str());
+    close(m_fd);
+    m_fd = -1;
+    return true;
+  }
+  m_is_running = true;
+  m_thread = std::thread([this]() { run(); });
+  return true;
+}
+
+void TransformsWatcher::stop() {
+  m_is_running = false;
+  if (m_thread.joinable()) m_thread.join();
+  if (m_fd >= 0) {
+    close(m_fd);
+    m_fd = -1;
+  }
+}
+
+bool TransformsWatcher::reload() {
+  auto transforms = std::make_shared<SensorTransforms>();
+  if (!load(m_path, *transforms)) return false;
+  std::atomic_store(&m_transforms,
+                    std::shared_ptr<const SensorTransforms>(transforms));
+  return true;
+}
+
+void TransformsWatcher::run() {
+  const std::size_t i_separator = m_path.rfind('/');
+  const std::string filename = (i_separator == std::string::npos)
+                                   ? m_path
+                                   : m_path.substr(i_separator + 1);
+
+  alignas(struct inotify_event) std::array<char, 4096> buffer;
+  while (m_is_running) {
+    struct pollfd poll_fd = {m_fd, POLLIN, 0};
+    if (poll(&poll_fd, 1, 100) <= 0) continue;
+
+    bool is_changed = false;
+    ssize_t n_bytes;
+    while ((n_bytes = read(m_fd, buffer.data(), buffer.size())) > 0) {
+      for (ssize_t i = 0; i < n_bytes;) {
+        const auto *const event = (const struct inotify_event *)&buffer[i];
+        if (event->len && (filename == event->name)) is_changed = true;
+        i += sizeof(struct inotify_event) + event->len;
+      }
+    }
+    if (!is_changed) continue;
+    if (reload()) ROS_INFO("Reloaded transforms %s.", m_path.c_str());
+  }
+}
+
+}  // namespace cepton_ros
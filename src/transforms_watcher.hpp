@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <boost/property_tree/ptree_fwd.hpp>
+#include <cepton_sdk_util.hpp>
+
+namespace cepton_ros {
+
+/// Sensor transforms, by serial number.
+using SensorTransforms =
+    std::unordered_map<uint64_t, cepton_sdk::util::CompiledTransform>;
+
+/// Loads `cepton_transforms.json`, and reloads it when it changes.
+/**
+ * Watches the file with inotify in a background thread. On change, the file
+ * is parsed off the hot path, and the new transforms are swapped in
+ * atomically. If parsing fails, the previous transforms are kept.
+ */
+class TransformsWatcher {
+ public:
+  ~TransformsWatcher() { stop(); }
+
+  /// Loads file and starts watching it.
+  bool start(const std::string &path);
+  void stop();
+
+  /// Returns current transforms. Never blocks.
+  std::shared_ptr<const SensorTransforms> get() const {
+    return std::atomic_load(&m_transforms);
+  }
+
+  /// Parses transforms file.
+  static bool load(const std::string &path, SensorTransforms &transforms);
+  /// Parses "translation" and "rotation" keys. Throws on invalid values.
+  static cepton_sdk::util::CompiledTransform parse_transform(
+      const boost::property_tree::ptree &tree);
+
+ private:
+  bool reload();
+  void run();
+
+ private:
+  std::string m_path;
+  std::shared_ptr<const SensorTransforms> m_transforms;
+
+  int m_fd = -1;
+  std::atomic<bool> m_is_running{false};
+  std::thread m_thread;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace cepton_ros {
+
+/// Lock free single producer, single consumer latest value buffer.
+/**
+ * The writer fills the write buffer and publishes it, and the reader picks
+ * up the latest published buffer. Neither side ever blocks or copies; the
+ * writer overwrites values the reader has not picked up.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  /// Writer only.
+  T &get_write_buffer() { return m_buffers[m_i_write]; }
+
+  /// Makes write buffer latest. Writer only.
+  void publish() {
+    const uint8_t state =
+        m_state.exchange(m_i_write | new_flag, std::memory_order_acq_rel);
+    m_i_write = state & index_mask;
+  }
+
+  /// Switches read buffer to latest, if any. Returns true if updated.
+  /// Reader only.
+  bool update() {
+    if (!(m_state.load(std::memory_order_acquire) & new_flag)) return false;
+    const uint8_t state =
+        m_state.exchange(m_i_read, std::memory_order_acq_rel);
+    m_i_read = state & index_mask;
+    m_has_value = true;
+    return true;
+  }
+
+  /// Clears values, and releases buffers. Must not be called concurrently
+  /// with the reader or writer.
+  void reset() {
+    for (auto &buffer : m_buffers) buffer = T();
+    m_i_write = 0;
+    m_state.store(1, std::memory_order_release);
+    m_i_read = 2;
+    m_has_value = false;
+  }
+
+  /// Returns true if read buffer has been published. Reader only.
+  bool has_value() const { return m_has_value; }
+  /// Reader only.
+  const T &get_read_buffer() const { return m_buffers[m_i_read]; }
+
+ private:
+  static const uint8_t index_mask = 0x3;
+  static const uint8_t new_flag = 0x4;
+
+  std::array<T, 3> m_buffers;
+  uint8_t m_i_write = 0;
+  /// Middle buffer index, and new flag.
+  std::atomic<uint8_t> m_state{1};
+  uint8_t m_i_read = 2;
+  bool m_has_value = false;
+};
+
+}  // namespace cepton_ros
@@ -0,0 +1,75 @@
+#include <cstdint>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "clock_estimator.hpp"
+
+namespace cepton_ros {
+
+namespace {
+const int64_t sensor_t_0 = 1000000000;  ///< Free running sensor clock.
+const double host_offset = 1.55e15;
+const double true_drift = 50e-6;
+
+double get_true_host_time(int64_t sensor_time) {
+  return host_offset + double(sensor_time) * (1.0 + true_drift);
+}
+}  // namespace
+
+TEST(ClockEstimator, FitsMinimumDelay) {
+  ClockEstimator estimator;
+  std::mt19937 generator(1);
+  // Queueing delay with 0.5 ms mean, and occasional 50 ms spikes
+  std::exponential_distribution<double> delay_distribution(1.0 / 500.0);
+  for (int i = 0; i < 1000; ++i) {
+    const int64_t sensor_time = sensor_t_0 + i * 100000;  // 10 Hz
+    double delay = 100.0 + delay_distribution(generator);
+    if (i % 50 == 7) delay += 50000.0;
+    estimator.add_sample(sensor_time,
+                         int64_t(get_true_host_time(sensor_time) + delay));
+  }
+  ASSERT_TRUE(estimator.is_valid());
+  EXPECT_NEAR(estimator.drift, true_drift, 5e-6);
+  EXPECT_LT(estimator.sigma, 1e-3);
+
+  // Maps to host time plus minimum delay (100 us), not mean delay (600 us)
+  const int64_t sensor_time = sensor_t_0 + 1000 * 100000;
+  const double error = double(estimator.to_host(sensor_time)) -
+                       get_true_host_time(sensor_time) - 100.0;
+  EXPECT_NEAR(error, 0.0, 50.0);
+}
+
+TEST(ClockEstimator, ResetsOnClockJump) {
+  ClockEstimator estimator;
+  for (int i = 0; i < 200; ++i) {
+    const int64_t sensor_time = sensor_t_0 + i * 100000;
+    estimator.add_sample(sensor_time,
+                         int64_t(get_true_host_time(sensor_time)) + 200);
+  }
+  ASSERT_TRUE(estimator.is_valid());
+
+  // Sensor clock jumps 10 s ahead (e.g. PTP lock)
+  const int64_t jump = 10000000;
+  int64_t host_time = 0;
+  for (int i = 200; i < 400; ++i) {
+    host_time = int64_t(get_true_host_time(sensor_t_0 + i * 100000)) + 200;
+    estimator.add_sample(sensor_t_0 + i * 100000 + jump, host_time);
+  }
+  ASSERT_TRUE(estimator.is_valid());
+  EXPECT_NEAR(double(estimator.to_host(sensor_t_0 + 399 * 100000 + jump)),
+              double(host_time), 10.0);
+}
+
+TEST(ClockEstimator, RequiresMinSamples) {
+  ClockEstimator estimator;
+  for (std::size_t i = 0; i + 1 < estimator.min_samples; ++i)
+    estimator.add_sample(sensor_t_0 + i * 100000, 100);
+  EXPECT_FALSE(estimator.is_valid());
+  estimator.add_sample(sensor_t_0 + estimator.min_samples * 100000, 100);
+  EXPECT_TRUE(estimator.is_valid());
+  estimator.reset();
+  EXPECT_FALSE(estimator.is_valid());
+}
+
+}  // namespace cepton_ros
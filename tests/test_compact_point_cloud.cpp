@@ -0,0 +1,125 @@
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "compact_encoder.hpp"
+
+namespace cepton_ros {
+
+namespace {
+CeptonPointCloud make_point_cloud(float max_value, int n_points) {
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<float> distribution(-max_value, max_value);
+  CeptonPointCloud point_cloud;
+  for (int i = 0; i < n_points; ++i) {
+    cepton_sdk::util::SensorPoint point = {};
+    point.valid = 1;
+    point.x = distribution(generator);
+    point.y = distribution(generator);
+    point.z = distribution(generator);
+    point.intensity = std::abs(distribution(generator)) / max_value;
+    point_cloud.push_back(point);
+  }
+  return point_cloud;
+}
+}  // namespace
+
+TEST(CompactPointCloud, HalfConversion) {
+  // Exactly representable
+  for (const float value : {0.0f, 1.0f, -2.5f, 1024.0f, 65504.0f, 0.125f})
+    EXPECT_EQ(half_to_float(float_to_half(value)), value);
+  EXPECT_EQ(float_to_half(1.0f), 0x3c00);
+  EXPECT_EQ(float_to_half(-2.0f), 0xc000);
+
+  // Round to nearest even (spacing is 1 in [1024, 2048))
+  EXPECT_EQ(half_to_float(float_to_half(1024.5f)), 1024.0f);
+  EXPECT_EQ(half_to_float(float_to_half(1025.5f)), 1026.0f);
+
+  // Overflow, NaN, and denormals
+  EXPECT_TRUE(std::isinf(half_to_float(float_to_half(1e6f))));
+  EXPECT_TRUE(std::isnan(
+      half_to_float(float_to_half(std::numeric_limits<float>::quiet_NaN()))));
+  const float denormal = std::ldexp(1.0f, -20);
+  EXPECT_EQ(half_to_float(float_to_half(denormal)), denormal);
+}
+
+TEST(CompactPointCloud, HalfConversionVectorMatchesScalar) {
+  // Not a multiple of vector width
+  const float values[7] = {0.1f, -37.3f, 199.9f, 1e-5f, 1024.5f, -0.0f, 1e6f};
+  uint16_t result[7];
+  float_to_half_n(values, 7, result);
+  for (int i = 0; i < 7; ++i) EXPECT_EQ(result[i], float_to_half(values[i]));
+}
+
+TEST(CompactPointCloud, Float16RoundTrip) {
+  const auto point_cloud = make_point_cloud(200.0f, 1000);
+  CompactPointCloud msg;
+  encode_compact_point_cloud(point_cloud, CompactPointCloud::ENCODING_FLOAT16,
+                             0.01f, msg);
+  EXPECT_EQ(msg.n_points, 1000u);
+  EXPECT_EQ(msg.data.size(), 1000u * 8);
+
+  CeptonPointCloud result;
+  decode_compact_point_cloud(msg, result);
+  ASSERT_EQ(result.size(), point_cloud.size());
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    // 11 bit mantissa
+    const auto &point = point_cloud.points[i];
+    EXPECT_NEAR(result.points[i].x, point.x, std::abs(point.x) / 2048);
+    EXPECT_NEAR(result.points[i].y, point.y, std::abs(point.y) / 2048);
+    EXPECT_NEAR(result.points[i].z, point.z, std::abs(point.z) / 2048);
+    EXPECT_NEAR(result.points[i].intensity, point.intensity, 1.0f / 2048);
+  }
+}
+
+TEST(CompactPointCloud, Int16RoundTrip) {
+  const float resolution = 0.005f;
+  auto point_cloud = make_point_cloud(100.0f, 1000);
+  point_cloud.points[3].valid = 0;
+  CompactPointCloud msg;
+  encode_compact_point_cloud(point_cloud, CompactPointCloud::ENCODING_INT16,
+                             resolution, msg);
+  EXPECT_EQ(msg.scale, resolution);
+  EXPECT_EQ(msg.n_points, 999u);
+  EXPECT_EQ(msg.data.size(), 999u * 7);
+
+  CeptonPointCloud result;
+  decode_compact_point_cloud(msg, result);
+  ASSERT_EQ(result.size(), 999u);
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    const auto &point = point_cloud.points[(i < 3) ? i : i + 1];
+    EXPECT_NEAR(result.points[i].x, point.x, 0.5f * resolution + 1e-5f);
+    EXPECT_NEAR(result.points[i].y, point.y, 0.5f * resolution + 1e-5f);
+    EXPECT_NEAR(result.points[i].z, point.z, 0.5f * resolution + 1e-5f);
+    EXPECT_NEAR(result.points[i].intensity, point.intensity, 0.5f / 255);
+  }
+}
+
+TEST(CompactPointCloud, Int16ScaleFitsFarPoints) {
+  const auto point_cloud = make_point_cloud(300.0f, 100);
+  CompactPointCloud msg;
+  encode_compact_point_cloud(point_cloud, CompactPointCloud::ENCODING_INT16,
+                             0.005f, msg);
+  EXPECT_GT(msg.scale, 0.005f);
+
+  CeptonPointCloud result;
+  decode_compact_point_cloud(msg, result);
+  ASSERT_EQ(result.size(), point_cloud.size());
+  for (std::size_t i = 0; i < result.size(); ++i)
+    EXPECT_NEAR(result.points[i].x, point_cloud.points[i].x, msg.scale);
+}
+
+TEST(CompactPointCloud, RejectsTruncatedMessage) {
+  const auto point_cloud = make_point_cloud(10.0f, 10);
+  CompactPointCloud msg;
+  encode_compact_point_cloud(point_cloud, CompactPointCloud::ENCODING_FLOAT16,
+                             0.01f, msg);
+  msg.data.pop_back();
+  CeptonPointCloud result;
+  decode_compact_point_cloud(msg, result);
+  EXPECT_TRUE(result.empty());
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,128 @@
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "cepton_ros/delta_frame.hpp"
+
+namespace cepton_ros {
+
+namespace {
+/// Returns one point per cell of a small grid, at `distance`.
+CeptonPointCloud make_point_cloud(const ImageGrid &grid, int n_points,
+                                  float distance) {
+  CeptonPointCloud point_cloud;
+  for (int i = 0; i < n_points; ++i) {
+    cepton_sdk::util::SensorPoint point = {};
+    point.valid = 1;
+    point.image_x = -grid.extent + (i + 0.5f) * grid.resolution;
+    point.image_z = 0.5f * grid.resolution;
+    point.distance = distance;
+    point.intensity = 0.5f;
+    point_cloud.push_back(point);
+  }
+  return point_cloud;
+}
+
+std::vector<float> get_distances(const CeptonPointCloud &point_cloud) {
+  std::vector<float> distances;
+  for (const auto &point : point_cloud.points)
+    distances.push_back(point.distance);
+  std::sort(distances.begin(), distances.end());
+  return distances;
+}
+}  // namespace
+
+class DeltaFrameTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    encoder.grid = ImageGrid(0.1f, 1.0f);
+    encoder.keyframe_interval = 4;
+  }
+
+  DeltaEncoder encoder;
+  DeltaDecoder decoder;
+};
+
+TEST_F(DeltaFrameTest, SendsOnlyChanges) {
+  auto point_cloud = make_point_cloud(encoder.grid, 10, 10.0f);
+  DeltaFrame msg;
+  encoder.encode(point_cloud, msg);
+  EXPECT_TRUE(msg.is_keyframe);
+  EXPECT_EQ(msg.cells.size(), 10u);
+  ASSERT_TRUE(decoder.add_delta(msg));
+  EXPECT_EQ(decoder.get_frame().size(), 10u);
+
+  // Small change is not sent
+  point_cloud.points[0].distance += 0.01f;
+  point_cloud.points[1].distance += 1.0f;
+  point_cloud.points.pop_back();
+  encoder.encode(point_cloud, msg);
+  EXPECT_FALSE(msg.is_keyframe);
+  EXPECT_EQ(msg.cells.size(), 1u);
+  EXPECT_EQ(msg.removed_cells.size(), 1u);
+  ASSERT_TRUE(decoder.add_delta(msg));
+  const auto distances = get_distances(decoder.get_frame());
+  ASSERT_EQ(distances.size(), 9u);
+  EXPECT_EQ(distances.back(), 11.0f);
+}
+
+TEST_F(DeltaFrameTest, PeriodicKeyframe) {
+  const auto point_cloud = make_point_cloud(encoder.grid, 10, 10.0f);
+  DeltaFrame msg;
+  for (int i = 0; i < 9; ++i) {
+    encoder.encode(point_cloud, msg);
+    EXPECT_EQ(msg.sequence, uint32_t(i));
+    EXPECT_EQ(msg.is_keyframe, (i % 4) == 0);
+    EXPECT_EQ(msg.cells.size(), msg.is_keyframe ? 10u : 0u);
+  }
+}
+
+TEST_F(DeltaFrameTest, DropsDeltasAfterGap) {
+  auto point_cloud = make_point_cloud(encoder.grid, 10, 10.0f);
+  DeltaFrame msg;
+  encoder.encode(point_cloud, msg);
+  ASSERT_TRUE(decoder.add_delta(msg));
+
+  // Lost message
+  point_cloud.points[0].distance = 20.0f;
+  encoder.encode(point_cloud, msg);
+  point_cloud.points[1].distance = 30.0f;
+  encoder.encode(point_cloud, msg);
+  EXPECT_FALSE(decoder.add_delta(msg));
+  encoder.encode(point_cloud, msg);
+  EXPECT_FALSE(decoder.add_delta(msg));
+
+  // Recovers at keyframe
+  encoder.encode(point_cloud, msg);
+  ASSERT_TRUE(msg.is_keyframe);
+  ASSERT_TRUE(decoder.add_delta(msg));
+  EXPECT_EQ(get_distances(decoder.get_frame()),
+            get_distances(point_cloud));
+}
+
+TEST_F(DeltaFrameTest, WaitsForKeyframe) {
+  const auto point_cloud = make_point_cloud(encoder.grid, 10, 10.0f);
+  DeltaFrame msg;
+  encoder.encode(point_cloud, msg);
+  encoder.encode(point_cloud, msg);
+  EXPECT_FALSE(decoder.add_delta(msg));
+}
+
+TEST_F(DeltaFrameTest, KeepsNearestPointPerCell) {
+  auto point_cloud = make_point_cloud(encoder.grid, 2, 10.0f);
+  auto second_return = point_cloud.points[0];
+  second_return.distance = 5.0f;
+  point_cloud.push_back(second_return);
+  auto outside = point_cloud.points[0];
+  outside.image_x = 2.0f;
+  point_cloud.push_back(outside);
+
+  DeltaFrame msg;
+  encoder.encode(point_cloud, msg);
+  EXPECT_EQ(encoder.n_dropped, 2u);
+  ASSERT_TRUE(decoder.add_delta(msg));
+  EXPECT_EQ(get_distances(decoder.get_frame()),
+            (std::vector<float>{5.0f, 10.0f}));
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "cepton_ros/frame_assembler.hpp"
+
+namespace cepton_ros {
+
+namespace {
+/// Returns chunk with points `[i_start, i_end)` of frame.
+PointCloudChunk make_chunk(uint32_t frame_index, uint32_t chunk_index,
+                           int i_start, int i_end, bool is_last) {
+  CeptonPointCloud point_cloud;
+  point_cloud.header.stamp = 1000 * frame_index + i_end;
+  point_cloud.header.frame_id = "cepton_1";
+  for (int i = i_start; i < i_end; ++i) {
+    cepton_sdk::util::SensorPoint point = {};
+    point.timestamp = i;
+    point.x = float(i);
+    point_cloud.push_back(point);
+  }
+  PointCloudChunk chunk;
+  chunk.frame_index = frame_index;
+  chunk.chunk_index = chunk_index;
+  chunk.is_last = is_last;
+  pcl::toROSMsg(point_cloud, chunk.points);
+  return chunk;
+}
+}  // namespace
+
+TEST(FrameAssembler, AssemblesChunks) {
+  FrameAssembler assembler;
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(3, 0, 0, 4, false)));
+  EXPECT_EQ(assembler.get_chunk().size(), 4u);
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(3, 1, 4, 8, false)));
+  ASSERT_TRUE(assembler.add_chunk(make_chunk(3, 2, 8, 10, true)));
+
+  const auto &frame = assembler.get_frame();
+  ASSERT_EQ(frame.size(), 10u);
+  EXPECT_EQ(frame.width, 10u);
+  EXPECT_EQ(frame.height, 1u);
+  EXPECT_EQ(frame.header.stamp, 3010u);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(frame.points[i].timestamp, i);
+    EXPECT_EQ(frame.points[i].x, float(i));
+  }
+}
+
+TEST(FrameAssembler, KeepsHeaderOfLastNonEmptyChunk) {
+  FrameAssembler assembler;
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(0, 0, 0, 4, false)));
+  ASSERT_TRUE(assembler.add_chunk(make_chunk(0, 1, 4, 4, true)));
+  EXPECT_EQ(assembler.get_frame().size(), 4u);
+  EXPECT_EQ(assembler.get_frame().header.stamp, 4u);
+}
+
+TEST(FrameAssembler, DropsFrameWithMissingChunk) {
+  FrameAssembler assembler;
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(0, 0, 0, 4, false)));
+  // Chunk 1 is lost
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(0, 2, 8, 10, true)));
+
+  // Frame with lost first chunk is dropped
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(1, 1, 4, 8, false)));
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(1, 2, 8, 10, true)));
+
+  // Next frame is assembled
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(2, 0, 0, 5, false)));
+  ASSERT_TRUE(assembler.add_chunk(make_chunk(2, 1, 5, 10, true)));
+  EXPECT_EQ(assembler.get_frame().size(), 10u);
+}
+
+TEST(FrameAssembler, DropsFrameOnFrameIndexChange) {
+  FrameAssembler assembler;
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(0, 0, 0, 4, false)));
+  EXPECT_FALSE(assembler.add_chunk(make_chunk(1, 1, 4, 10, true)));
+}
+
+}  // namespace cepton_ros
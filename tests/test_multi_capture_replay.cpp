@@ -0,0 +1,128 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "multi_capture_replay.hpp"
+
+namespace cepton_ros {
+
+namespace {
+void write_u16_be(std::vector<uint8_t> &data, uint16_t value) {
+  data.push_back(value >> 8);
+  data.push_back(value & 0xff);
+}
+
+void write_u32(std::vector<uint8_t> &data, uint32_t value) {
+  for (int i = 0; i < 4; ++i) data.push_back((value >> (8 * i)) & 0xff);
+}
+
+/// Writes ethernet PCAP with one UDP packet per timestamp [microseconds].
+std::string write_capture(const std::string &name, uint32_t source_ip,
+                          const std::vector<int64_t> &timestamps) {
+  std::vector<uint8_t> data;
+  write_u32(data, 0xa1b2c3d4);
+  write_u32(data, 0x00040002);  // Version 2.4
+  write_u32(data, 0);
+  write_u32(data, 0);
+  write_u32(data, 65535);
+  write_u32(data, 1);  // Ethernet
+  for (const int64_t timestamp : timestamps) {
+    std::vector<uint8_t> frame(12, 0);
+    write_u16_be(frame, 0x0800);
+    // IPv4
+    const std::size_t payload_size = 16;
+    frame.push_back(0x45);
+    frame.push_back(0);
+    write_u16_be(frame, 20 + 8 + payload_size);
+    write_u16_be(frame, 0);
+    write_u16_be(frame, 0);
+    frame.push_back(64);
+    frame.push_back(17);  // UDP
+    write_u16_be(frame, 0);
+    for (int i = 3; i >= 0; --i) frame.push_back((source_ip >> (8 * i)) & 0xff);
+    for (int i = 0; i < 4; ++i) frame.push_back(0xff);
+    // UDP
+    write_u16_be(frame, 8808);
+    write_u16_be(frame, 8808);
+    write_u16_be(frame, 8 + payload_size);
+    write_u16_be(frame, 0);
+    frame.resize(frame.size() + payload_size, 0);
+
+    write_u32(data, timestamp / 1000000);
+    write_u32(data, timestamp % 1000000);
+    write_u32(data, frame.size());
+    write_u32(data, frame.size());
+    data.insert(data.end(), frame.begin(), frame.end());
+  }
+  const std::string path = testing::TempDir() + name;
+  FILE *const file = std::fopen(path.c_str(), "wb");
+  std::fwrite(data.data(), 1, data.size(), file);
+  std::fclose(file);
+  return path;
+}
+
+/// Replays packets until end, and returns their timestamps.
+std::vector<int64_t> replay_all(MultiCaptureReplay &replay,
+                                std::size_t max_packets = 100) {
+  std::vector<int64_t> timestamps;
+  for (std::size_t i = 0; i < max_packets; ++i) {
+    // SDK is not initialized, so only EOF is checked
+    const auto error = replay.resume_blocking_once();
+    if (error.code == CEPTON_ERROR_EOF) break;
+    timestamps.push_back(replay.get_time());
+  }
+  return timestamps;
+}
+
+const int64_t t_0 = 1000000000;
+}  // namespace
+
+TEST(MultiCaptureReplay, MergesByTimestamp) {
+  const auto path_a =
+      write_capture("a.pcap", 0x0a000001, {t_0 + 100, t_0 + 300, t_0 + 500});
+  // Out of order packets in a capture are sorted
+  const auto path_b =
+      write_capture("b.pcap", 0x0a000002, {t_0 + 250, t_0 + 200, t_0 + 600});
+
+  MultiCaptureReplay replay;
+  ASSERT_FALSE(replay.open({path_a, path_b}));
+  EXPECT_EQ(replay.get_start_time(), t_0 + 100);
+  EXPECT_FLOAT_EQ(replay.get_length(), 500e-6f);
+  const std::vector<int64_t> expected = {t_0 + 100, t_0 + 200, t_0 + 250,
+                                         t_0 + 300, t_0 + 500, t_0 + 600};
+  EXPECT_EQ(replay_all(replay), expected);
+  EXPECT_TRUE(replay.is_end());
+}
+
+TEST(MultiCaptureReplay, SeekAndLoop) {
+  const auto path_a =
+      write_capture("a.pcap", 0x0a000001, {t_0 + 100, t_0 + 300, t_0 + 500});
+  const auto path_b = write_capture("b.pcap", 0x0a000002, {t_0 + 400});
+
+  MultiCaptureReplay replay;
+  ASSERT_FALSE(replay.open({path_a, path_b}));
+  ASSERT_FALSE(replay.seek(250e-6f));
+  const std::vector<int64_t> expected = {t_0 + 400, t_0 + 500};
+  EXPECT_EQ(replay_all(replay), expected);
+
+  ASSERT_FALSE(replay.seek(0.0f));
+  ASSERT_FALSE(replay.set_enable_loop(true));
+  const std::vector<int64_t> expected_loop = {
+      t_0 + 100, t_0 + 300, t_0 + 400, t_0 + 500, t_0 + 100, t_0 + 300};
+  EXPECT_EQ(replay_all(replay, expected_loop.size()), expected_loop);
+}
+
+TEST(MultiCaptureReplay, RejectsInvalidCapture) {
+  const std::string path = testing::TempDir() + "invalid.pcap";
+  FILE *const file = std::fopen(path.c_str(), "wb");
+  std::fputs("not a capture, not a capture", file);
+  std::fclose(file);
+
+  MultiCaptureReplay replay;
+  EXPECT_TRUE(replay.open({path}));
+  EXPECT_FALSE(replay.is_open());
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,187 @@
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "multicast_transport.hpp"
+
+namespace cepton_ros {
+
+namespace {
+using Datagram = std::vector<uint8_t>;
+
+std::vector<uint8_t> make_frame(std::size_t size, uint8_t seed) {
+  std::vector<uint8_t> frame(size);
+  for (std::size_t i = 0; i < size; ++i) frame[i] = uint8_t(seed + i);
+  return frame;
+}
+
+/// Splits frame into datagrams, like `MulticastSender`.
+std::vector<Datagram> make_datagrams(uint32_t frame_index,
+                                     const std::vector<uint8_t> &frame,
+                                     std::size_t payload_size) {
+  const std::size_t n_fragments = std::max<std::size_t>(
+      (frame.size() + payload_size - 1) / payload_size, 1);
+  std::vector<Datagram> datagrams;
+  for (std::size_t i = 0; i < n_fragments; ++i) {
+    MulticastFragmentHeader header;
+    header.magic = {{'C', 'M', 'C', '1'}};
+    header.frame_index = frame_index;
+    header.frame_size = frame.size();
+    header.offset = i * payload_size;
+    header.fragment_index = i;
+    header.n_fragments = n_fragments;
+    const std::size_t size =
+        std::min(payload_size, frame.size() - header.offset);
+    Datagram datagram(sizeof(header) + size);
+    std::memcpy(datagram.data(), &header, sizeof(header));
+    std::memcpy(datagram.data() + sizeof(header), frame.data() + header.offset,
+                size);
+    datagrams.push_back(datagram);
+  }
+  return datagrams;
+}
+
+/// Returns number of completed frames.
+int add_datagrams(FrameReassembler &reassembler,
+                  const std::vector<Datagram> &datagrams,
+                  std::vector<uint8_t> &frame) {
+  int n_frames = 0;
+  for (const auto &datagram : datagrams) {
+    if (reassembler.add_datagram(datagram.data(), datagram.size(), frame))
+      ++n_frames;
+  }
+  return n_frames;
+}
+}  // namespace
+
+TEST(FrameReassembler, Reassembles) {
+  FrameReassembler reassembler;
+  const auto expected = make_frame(10000, 1);
+  auto datagrams = make_datagrams(0, expected, 1400);
+  ASSERT_EQ(datagrams.size(), 8u);
+  std::swap(datagrams[0], datagrams[5]);
+  std::swap(datagrams[2], datagrams[7]);
+
+  std::vector<uint8_t> frame;
+  EXPECT_EQ(add_datagrams(reassembler, datagrams, frame), 1);
+  EXPECT_EQ(frame, expected);
+  EXPECT_EQ(reassembler.get_n_dropped(), 0u);
+
+  // Empty frame
+  EXPECT_EQ(add_datagrams(reassembler, make_datagrams(1, {}, 1400), frame), 1);
+  EXPECT_TRUE(frame.empty());
+}
+
+TEST(FrameReassembler, IgnoresDuplicatesAndInvalidDatagrams) {
+  FrameReassembler reassembler;
+  const auto expected = make_frame(3000, 2);
+  auto datagrams = make_datagrams(0, expected, 1400);
+  datagrams.insert(datagrams.begin() + 1, datagrams[0]);
+
+  auto bad_magic = datagrams[0];
+  bad_magic[0] = 'X';
+  auto bad_offset = datagrams[0];
+  MulticastFragmentHeader header;
+  std::memcpy(&header, bad_offset.data(), sizeof(header));
+  header.offset = 2000;
+  std::memcpy(bad_offset.data(), &header, sizeof(header));
+  const Datagram truncated(datagrams[0].begin(), datagrams[0].begin() + 4);
+  datagrams.insert(datagrams.begin(), {bad_magic, bad_offset, truncated});
+
+  std::vector<uint8_t> frame;
+  EXPECT_EQ(add_datagrams(reassembler, datagrams, frame), 1);
+  EXPECT_EQ(frame, expected);
+}
+
+TEST(FrameReassembler, DropsIncompleteFrames) {
+  FrameReassembler reassembler;
+  auto incomplete = make_datagrams(0, make_frame(3000, 3), 1400);
+  incomplete.pop_back();
+  const auto expected = make_frame(3000, 4);
+
+  std::vector<uint8_t> frame;
+  EXPECT_EQ(add_datagrams(reassembler, incomplete, frame), 0);
+  EXPECT_EQ(add_datagrams(reassembler, make_datagrams(1, expected, 1400),
+                          frame),
+            1);
+  EXPECT_EQ(frame, expected);
+  EXPECT_EQ(reassembler.get_n_dropped(), 1u);
+}
+
+TEST(FrameReassembler, InterleavedFrames) {
+  FrameReassembler reassembler;
+  const auto expected_0 = make_frame(3000, 5);
+  const auto expected_1 = make_frame(3000, 6);
+  const auto datagrams_0 = make_datagrams(0, expected_0, 1400);
+  const auto datagrams_1 = make_datagrams(1, expected_1, 1400);
+  std::vector<Datagram> datagrams;
+  for (std::size_t i = 0; i < datagrams_0.size(); ++i) {
+    datagrams.push_back(datagrams_0[i]);
+    datagrams.push_back(datagrams_1[i]);
+  }
+
+  std::vector<uint8_t> frame;
+  std::vector<std::vector<uint8_t>> frames;
+  for (const auto &datagram : datagrams) {
+    if (reassembler.add_datagram(datagram.data(), datagram.size(), frame))
+      frames.push_back(frame);
+  }
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0], expected_0);
+  EXPECT_EQ(frames[1], expected_1);
+  EXPECT_EQ(reassembler.get_n_dropped(), 0u);
+}
+
+TEST(FrameReassembler, MaxPartialFrames) {
+  FrameReassembler reassembler;
+  reassembler.max_partial_frames = 2;
+  std::vector<uint8_t> frame;
+  for (uint32_t i = 0; i < 4; ++i) {
+    auto datagrams = make_datagrams(i, make_frame(3000, i), 1400);
+    datagrams.pop_back();
+    EXPECT_EQ(add_datagrams(reassembler, datagrams, frame), 0);
+  }
+  EXPECT_EQ(reassembler.get_n_dropped(), 2u);
+}
+
+TEST(FrameReassembler, FrameIndexWraparound) {
+  FrameReassembler reassembler;
+  auto incomplete = make_datagrams(0xFFFFFFFF, make_frame(3000, 7), 1400);
+  incomplete.pop_back();
+  const auto expected = make_frame(100, 8);
+
+  std::vector<uint8_t> frame;
+  EXPECT_EQ(add_datagrams(reassembler, incomplete, frame), 0);
+  EXPECT_EQ(add_datagrams(reassembler, make_datagrams(0, expected, 1400),
+                          frame),
+            1);
+  EXPECT_EQ(frame, expected);
+  EXPECT_EQ(reassembler.get_n_dropped(), 1u);
+}
+
+TEST(MulticastSender, DropsOldestQueuedFrame) {
+  MulticastSender sender;
+  // Sending thread stalls on the first frame
+  sender.max_rate = 1000.0;
+  sender.max_burst = 0;
+  sender.max_queue_size = 2;
+  ASSERT_TRUE(sender.open("239.255.0.1", 7510, 0, "", 1500));
+  for (uint8_t i = 0; i < 4; ++i) {
+    auto frame = make_frame(3000, i);
+    sender.send(frame);
+    EXPECT_NE(frame, make_frame(3000, i));
+  }
+  // Frame 1 or 2 was dropped, depending on when the thread took frame 0
+  EXPECT_GE(sender.get_n_dropped(), 1u);
+  EXPECT_LE(sender.get_n_dropped(), 2u);
+
+  // Close interrupts pacing
+  const auto start_time = std::chrono::steady_clock::now();
+  sender.close();
+  EXPECT_LT(std::chrono::steady_clock::now() - start_time,
+            std::chrono::seconds(1));
+}
+
+}  // namespace cepton_ros
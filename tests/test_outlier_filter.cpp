@@ -0,0 +1,127 @@
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "outlier_filter.hpp"
+
+namespace cepton_ros {
+
+namespace {
+cepton_sdk::util::SensorPoint make_point(float image_x, float image_z,
+                                         float distance) {
+  cepton_sdk::util::SensorPoint point = {};
+  point.valid = 1;
+  point.image_x = image_x;
+  point.image_z = image_z;
+  point.distance = distance;
+  return point;
+}
+
+/// Brute force O(points^2) reference.
+std::size_t count_inliers(const OutlierFilter &filter,
+                          const CeptonPointCloud &point_cloud) {
+  const auto &grid = filter.grid;
+  std::size_t n_inliers = 0;
+  for (const auto &point : point_cloud.points) {
+    int i_x, i_z;
+    if (!point.valid ||
+        !grid.get_cell(point.image_x, point.image_z, i_x, i_z)) {
+      ++n_inliers;
+      continue;
+    }
+    double n = 0.0, sum = 0.0, sum_squared = 0.0;
+    bool is_self = true;
+    for (const auto &other : point_cloud.points) {
+      int o_x, o_z;
+      if (!other.valid ||
+          !grid.get_cell(other.image_x, other.image_z, o_x, o_z))
+        continue;
+      if ((std::abs(o_x - i_x) > filter.radius) ||
+          (std::abs(o_z - i_z) > filter.radius))
+        continue;
+      // Exclude point once
+      if (is_self && (&other == &point)) {
+        is_self = false;
+        continue;
+      }
+      n += 1.0;
+      sum += other.distance;
+      sum_squared += double(other.distance) * other.distance;
+    }
+    if (n < filter.min_neighbors) continue;
+    const double mean = sum / n;
+    const double sigma =
+        std::sqrt(std::max(sum_squared / n - mean * mean, 0.0));
+    if (std::abs(point.distance - mean) <=
+        filter.std_ratio * sigma + filter.min_tolerance)
+      ++n_inliers;
+  }
+  return n_inliers;
+}
+}  // namespace
+
+TEST(OutlierFilter, DropsIsolatedAndFarPoints) {
+  OutlierFilter filter;
+  CeptonPointCloud point_cloud;
+  // 3x3 cells of points at 10 m, with one point at 30 m in the center
+  for (int i = 0; i < 9; ++i) {
+    point_cloud.push_back(make_point(0.005f + 0.01f * (i % 3),
+                                     0.005f + 0.01f * (i / 3), 10.0f));
+  }
+  point_cloud.points[4].distance = 30.0f;
+  // Isolated point
+  point_cloud.push_back(make_point(0.5f, 0.5f, 10.0f));
+  // Invalid and out of grid points are kept
+  auto invalid_point = make_point(0.5f, 0.5f, 10.0f);
+  invalid_point.valid = 0;
+  point_cloud.push_back(invalid_point);
+  point_cloud.push_back(make_point(1.5f, 0.0f, 10.0f));
+
+  CeptonPointCloud output;
+  filter.filter(point_cloud, output);
+  ASSERT_EQ(output.size(), 10u);
+  for (const auto &point : output.points) {
+    EXPECT_EQ(point.distance, 10.0f);
+    EXPECT_FALSE(point.valid && (point.image_x == 0.5f));
+  }
+}
+
+TEST(OutlierFilter, MatchesBruteForce) {
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<float> image_distribution(-0.2f, 0.2f);
+  std::normal_distribution<float> distance_distribution(20.0f, 2.0f);
+  OutlierFilter filter;
+  for (const int radius : {1, 2}) {
+    filter.radius = radius;
+    // Consecutive frames reuse buffers
+    for (int i_frame = 0; i_frame < 3; ++i_frame) {
+      CeptonPointCloud point_cloud;
+      for (int i = 0; i < 2000; ++i) {
+        point_cloud.push_back(make_point(image_distribution(generator),
+                                         image_distribution(generator),
+                                         distance_distribution(generator)));
+      }
+      CeptonPointCloud output;
+      filter.filter(point_cloud, output);
+      EXPECT_EQ(output.size(), count_inliers(filter, point_cloud));
+      EXPECT_LT(output.size(), point_cloud.size());
+    }
+  }
+}
+
+TEST(OutlierFilter, MinNeighbors) {
+  OutlierFilter filter;
+  CeptonPointCloud point_cloud;
+  point_cloud.push_back(make_point(0.005f, 0.005f, 10.0f));
+  point_cloud.push_back(make_point(0.015f, 0.005f, 10.0f));
+  CeptonPointCloud output;
+  filter.filter(point_cloud, output);
+  EXPECT_EQ(output.size(), 0u);
+
+  filter.min_neighbors = 1;
+  filter.filter(point_cloud, output);
+  EXPECT_EQ(output.size(), 2u);
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,115 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "point_kernels.hpp"
+
+namespace cepton_ros {
+
+namespace {
+/// Measurements of `segment_count * return_count` points. Returns of a
+/// segment share a direction, except in odd measurements.
+std::vector<cepton_sdk::SensorImagePoint> make_image_points(
+    int segment_count, int return_count, int n_measurements) {
+  std::vector<cepton_sdk::SensorImagePoint> image_points;
+  for (int i_measurement = 0; i_measurement < n_measurements;
+       ++i_measurement) {
+    for (int i_segment = 0; i_segment < segment_count; ++i_segment) {
+      for (int i_return = 0; i_return < return_count; ++i_return) {
+        cepton_sdk::SensorImagePoint image_point = {};
+        image_point.timestamp = i_measurement;
+        image_point.image_x = -0.5f + 0.01f * i_measurement + 0.1f * i_segment;
+        image_point.image_z = 0.3f - 0.05f * i_segment;
+        if (i_measurement % 2) image_point.image_z += 0.001f * i_return;
+        image_point.distance = 10.0f + i_return;
+        image_point.intensity = 0.5f;
+        image_point.valid = true;
+        image_points.push_back(image_point);
+      }
+    }
+  }
+  return image_points;
+}
+
+cepton_sdk::util::CompiledTransform make_transform() {
+  const float translation[3] = {1.0f, -2.0f, 0.5f};
+  // 30 degrees about z
+  const float rotation[4] = {0.0f, 0.0f, 0.258819f, 0.965926f};
+  return cepton_sdk::util::CompiledTransform::create(translation, rotation);
+}
+
+cepton_sdk::util::CompiledTransform make_identity() {
+  const float translation[3] = {0.0f, 0.0f, 0.0f};
+  const float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+  return cepton_sdk::util::CompiledTransform::create(translation, rotation);
+}
+
+void check_convert(const PointKernels &kernels,
+                   cepton_sdk::util::CompiledTransform transform,
+                   int segment_count, int return_count) {
+  // Partial measurement at end
+  const auto image_points = make_image_points(segment_count, return_count, 5);
+  const std::size_t n_points = image_points.size() - 1;
+  std::vector<cepton_sdk::util::SensorPoint> points(n_points);
+  kernels.convert(transform, n_points, image_points.data(), points.data());
+  for (std::size_t i = 0; i < n_points; ++i) {
+    cepton_sdk::util::SensorPoint expected;
+    cepton_sdk::util::convert_sensor_image_point_to_point(image_points[i],
+                                                          expected);
+    transform.apply(expected.x, expected.y, expected.z);
+    EXPECT_EQ(points[i].timestamp, expected.timestamp);
+    EXPECT_EQ(points[i].image_x, expected.image_x);
+    EXPECT_EQ(points[i].image_z, expected.image_z);
+    EXPECT_EQ(points[i].distance, expected.distance);
+    EXPECT_EQ(points[i].intensity, expected.intensity);
+    EXPECT_EQ(points[i].valid, expected.valid);
+    EXPECT_NEAR(points[i].x, expected.x, 1e-4f);
+    EXPECT_NEAR(points[i].y, expected.y, 1e-4f);
+    EXPECT_NEAR(points[i].z, expected.z, 1e-4f);
+  }
+}
+}  // namespace
+
+TEST(PointKernels, SelectsGeometry) {
+  const auto &kernels = get_point_kernels(2, 2);
+  EXPECT_EQ(kernels.segment_count, 2);
+  EXPECT_EQ(kernels.return_count, 2);
+
+  const auto &generic_kernels = get_point_kernels(3, 1);
+  EXPECT_EQ(generic_kernels.segment_count, 0);
+  EXPECT_EQ(&get_point_kernels(0, 0), &generic_kernels);
+}
+
+TEST(PointKernels, ConvertMatchesSdk) {
+  for (const int segment_count : {1, 2, 3, 8}) {
+    for (const int return_count : {1, 2}) {
+      SCOPED_TRACE(segment_count);
+      SCOPED_TRACE(return_count);
+      for (const auto &transform : {make_identity(), make_transform()}) {
+        check_convert(get_point_kernels(segment_count, return_count),
+                      transform, segment_count, return_count);
+        check_convert(get_point_kernels(0, 0), transform, segment_count,
+                      return_count);
+      }
+    }
+  }
+}
+
+TEST(PointKernels, ConvertUnalignedStart) {
+  const auto image_points = make_image_points(2, 2, 4);
+  const auto &kernels = get_point_kernels(2, 2);
+  const std::size_t n_points = image_points.size() - 1;
+  std::vector<cepton_sdk::util::SensorPoint> points(n_points);
+  kernels.convert(make_identity(), n_points, image_points.data() + 1,
+                  points.data());
+  for (std::size_t i = 0; i < n_points; ++i) {
+    cepton_sdk::util::SensorPoint expected;
+    cepton_sdk::util::convert_sensor_image_point_to_point(image_points[i + 1],
+                                                          expected);
+    EXPECT_NEAR(points[i].x, expected.x, 1e-4f);
+    EXPECT_NEAR(points[i].y, expected.y, 1e-4f);
+    EXPECT_NEAR(points[i].z, expected.z, 1e-4f);
+  }
+}
+
+}  // namespace cepton_ros
@@ -0,0 +1,86 @@
+#include <cmath>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "cepton_ros/polar_point_cloud.hpp"
+
+namespace cepton_ros {
+
+namespace {
+CeptonPointCloud make_point_cloud(int n_points) {
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<float> image_distribution(-1.9f, 1.9f);
+  std::uniform_real_distribution<float> distance_distribution(0.5f, 200.0f);
+  CeptonPointCloud point_cloud;
+  for (int i = 0; i < n_points; ++i) {
+    cepton_sdk::util::SensorPoint point = {};
+    point.valid = 1;
+    point.image_x = image_distribution(generator);
+    point.image_z = image_distribution(generator);
+    point.distance = distance_distribution(generator);
+    point.intensity = 0.5f;
+    cepton_sdk::util::convert_image_point_to_point(
+        point.image_x, point.image_z, point.distance, point.x, point.y,
+        point.z);
+    point_cloud.push_back(point);
+  }
+  return point_cloud;
+}
+}  // namespace
+
+TEST(PolarPointCloud, RoundTrip) {
+  const auto point_cloud = make_point_cloud(1000);
+  const float range_resolution = 0.005f;
+  PolarPointCloud msg;
+  encode_polar_point_cloud(point_cloud, range_resolution, msg);
+  EXPECT_EQ(msg.n_points, 1000u);
+  EXPECT_EQ(msg.data.size(), 1000u * polar_point_size);
+
+  CeptonPointCloud result;
+  ASSERT_TRUE(decode_polar_point_cloud(msg, result, true));
+  ASSERT_EQ(result.size(), point_cloud.size());
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    const auto &expected = point_cloud.points[i];
+    const auto &point = result.points[i];
+    EXPECT_NEAR(point.image_x, expected.image_x, 0.6f * msg.image_scale);
+    EXPECT_NEAR(point.image_z, expected.image_z, 0.6f * msg.image_scale);
+    EXPECT_NEAR(point.y, expected.y, 0.5f * range_resolution + 1e-4f);
+    // Image quantization error scales with range
+    const float tolerance = range_resolution + msg.image_scale * expected.y;
+    EXPECT_NEAR(point.x, expected.x, tolerance);
+    EXPECT_NEAR(point.z, expected.z, tolerance);
+    EXPECT_NEAR(point.distance, expected.distance, 2.0f * tolerance);
+    EXPECT_NEAR(point.intensity, 0.5f, 1.0f / 255);
+  }
+}
+
+TEST(PolarPointCloud, DistanceOnlyIfRequested) {
+  const auto point_cloud = make_point_cloud(10);
+  PolarPointCloud msg;
+  encode_polar_point_cloud(point_cloud, 0.005f, msg);
+  CeptonPointCloud result;
+  ASSERT_TRUE(decode_polar_point_cloud(msg, result));
+  for (const auto &point : result.points) EXPECT_EQ(point.distance, 0.0f);
+}
+
+TEST(PolarPointCloud, SkipsInvalidPoints) {
+  auto point_cloud = make_point_cloud(10);
+  point_cloud.points[3].valid = 0;
+  point_cloud.points[7].valid = 0;
+  PolarPointCloud msg;
+  encode_polar_point_cloud(point_cloud, 0.005f, msg);
+  EXPECT_EQ(msg.n_points, 8u);
+}
+
+TEST(PolarPointCloud, RejectsTruncatedData) {
+  const auto point_cloud = make_point_cloud(10);
+  PolarPointCloud msg;
+  encode_polar_point_cloud(point_cloud, 0.005f, msg);
+  msg.data.resize(msg.data.size() - 1);
+  CeptonPointCloud result;
+  EXPECT_FALSE(decode_polar_point_cloud(msg, result));
+  EXPECT_TRUE(result.empty());
+}
+
+}  // namespace cepton_ros
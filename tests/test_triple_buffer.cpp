@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "triple_buffer.hpp"
+
+namespace cepton_ros {
+
+TEST(TripleBuffer, ReadsLatestValue) {
+  TripleBuffer<int> buffer;
+  EXPECT_FALSE(buffer.update());
+  EXPECT_FALSE(buffer.has_value());
+
+  buffer.get_write_buffer() = 1;
+  buffer.publish();
+  buffer.get_write_buffer() = 2;
+  buffer.publish();
+  ASSERT_TRUE(buffer.update());
+  EXPECT_TRUE(buffer.has_value());
+  EXPECT_EQ(buffer.get_read_buffer(), 2);
+
+  // No new value
+  EXPECT_FALSE(buffer.update());
+  EXPECT_EQ(buffer.get_read_buffer(), 2);
+
+  buffer.get_write_buffer() = 3;
+  buffer.publish();
+  ASSERT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.get_read_buffer(), 3);
+}
+
+TEST(TripleBuffer, WriterDoesNotOverwriteReadBuffer) {
+  TripleBuffer<int> buffer;
+  buffer.get_write_buffer() = 1;
+  buffer.publish();
+  ASSERT_TRUE(buffer.update());
+  for (int i = 2; i < 10; ++i) {
+    buffer.get_write_buffer() = i;
+    buffer.publish();
+    EXPECT_EQ(buffer.get_read_buffer(), 1);
+  }
+  ASSERT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.get_read_buffer(), 9);
+}
+
+TEST(TripleBuffer, Reset) {
+  TripleBuffer<int> buffer;
+  buffer.get_write_buffer() = 1;
+  buffer.publish();
+  ASSERT_TRUE(buffer.update());
+  buffer.get_write_buffer() = 2;
+  buffer.publish();
+
+  buffer.reset();
+  EXPECT_FALSE(buffer.has_value());
+  EXPECT_FALSE(buffer.update());
+  EXPECT_EQ(buffer.get_read_buffer(), 0);
+
+  buffer.get_write_buffer() = 3;
+  buffer.publish();
+  ASSERT_TRUE(buffer.update());
+  EXPECT_EQ(buffer.get_read_buffer(), 3);
+}
+
+TEST(TripleBuffer, Concurrent) {
+  // Each value is written as a pair, so torn reads are detected
+  struct Value {
+    int64_t a = 0;
+    int64_t b = 0;
+  };
+  TripleBuffer<Value> buffer;
+  const int64_t n_values = 100000;
+  std::thread writer([&buffer, n_values]() {
+    for (int64_t i = 1; i <= n_values; ++i) {
+      auto &value = buffer.get_write_buffer();
+      value.a = i;
+      value.b = -i;
+      buffer.publish();
+    }
+  });
+  int64_t last = 0;
+  while (last < n_values) {
+    if (!buffer.update()) continue;
+    const auto &value = buffer.get_read_buffer();
+    // Do not return before joining writer
+    EXPECT_EQ(value.b, -value.a);
+    EXPECT_GT(value.a, last);
+    if ((value.b != -value.a) || (value.a <= last)) break;
+    last = value.a;
+  }
+  writer.join();
+}
+
+}  // namespace cepton_ros